@@ -0,0 +1,577 @@
+//
+//  basicbintree.h
+//
+//  BasicBinTree Object: a self-balancing (AVL) binary search tree whose
+//  Nodes hold their keys inline, rather than pointing at a NodeData on the
+//  heap. It is a template on the key type, on the ordering of the keys and
+//  on the allocator the Nodes come from, so comparing integers or short
+//  strings compiles down to code inlined into each descent, and a descent
+//  touches one Node per level instead of a Node and its NodeData. Like
+//  BinTree, every operation is iterative.
+//
+//  Assumptions:
+//     -- Key is copyable and Compare is a strict weak ordering on it; two
+//        keys are equal when neither is less than the other
+//     -- Keys are stored by value, so the tree owns nothing the caller has
+//        to delete, and inserting a duplicate simply returns false
+//     -- Alloc is stateless, or equal between trees that are swapped or
+//        moved into one another
+//     -- BasicBinTree is a separate tree, not the base of BinTree; BinTree
+//        keeps the NodeData* interface (handing NodeData over to the tree)
+//        used by lab2 and the other trees. NodeDataTree stores NodeData by
+//        value and takes insert(const NodeData &), so it is not a drop-in
+//        replacement for BinTree
+
+#ifndef BASICBINTREE_H
+#define BASICBINTREE_H
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "nodedata.h"
+using namespace std;
+
+template <class Key, class Compare = less<Key>, class Alloc = allocator<Key> >
+class BasicBinTree {
+
+    // operator<< -------------------------------------------------------
+    // Prints an inorder traversal of the tree
+    template <class K, class C, class A>
+    friend ostream& operator<<(ostream &out, const BasicBinTree<K, C, A> &);
+
+public:
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // BasicBinTree ------------------------------------------------------
+    // Default Constructor : creates an empty tree ordered by compare
+    explicit BasicBinTree(const Compare &compare = Compare(),
+                          const Alloc &alloc = Alloc());
+
+    // BasicBinTree ------------------------------------------------------
+    // Copy Constructor : creates a deep copy of the inputTree, Node for Node
+    BasicBinTree(const BasicBinTree &);
+
+    // BasicBinTree ------------------------------------------------------
+    // Move Constructor : takes over the Nodes of inputTree, leaving it empty;
+    // it cannot throw unless moving the Compare can
+    BasicBinTree(BasicBinTree &&)
+        noexcept(is_nothrow_move_constructible<Compare>::value);
+
+    // ~BasicBinTree -----------------------------------------------------
+    // Destructor : Deallocates all Nodes
+    ~BasicBinTree();
+
+
+    // Assignment Operators ////////////////////////////////////////////////
+
+    // operator= --------------------------------------------------------
+    // overloaded =: deep copies the parameter tree into this
+    BasicBinTree& operator=(const BasicBinTree &);
+
+    // operator= --------------------------------------------------------
+    // overloaded move =: deallocates this tree and takes over the Nodes of
+    // the parameter tree, leaving it empty
+    BasicBinTree& operator=(BasicBinTree &&)
+        noexcept(is_nothrow_move_constructible<Compare>::value
+                 && is_nothrow_move_assignable<Compare>::value);
+
+    // swap -------------------------------------------------------------
+    // exchanges the contents of this tree and the parameter in O(1)
+    void swap(BasicBinTree &)
+        noexcept(is_nothrow_move_constructible<Compare>::value
+                 && is_nothrow_move_assignable<Compare>::value);
+
+
+    // Equality Operators //////////////////////////////////////////////////
+
+    // operator== / operator!= -------------------------------------------
+    // true if both trees have the same shape and equal keys in each Node
+    bool operator==(const BasicBinTree &) const;
+    bool operator!=(const BasicBinTree &) const;
+
+
+    // Mutators ////////////////////////////////////////////////////////////
+
+    // insert ---------------------------------------------------------------
+    // inserts a copy of the key, returning false if it is already present
+    bool insert(const Key &);
+
+    // remove ---------------------------------------------------------------
+    // removes the key equal to the input, returning false if there is none
+    bool remove(const Key &);
+
+    // makeEmpty ------------------------------------------------------------
+    // deallocates all Nodes
+    void makeEmpty();
+
+
+    // Accessors ///////////////////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether the key is in this tree, pointing
+    // keyRetrieved at the stored key if found and at NULL if not
+    bool retrieve(const Key &, const Key* &) const;
+
+    // getHeight ------------------------------------------------------------
+    // returns the height of the subtree holding the key, 1 for a leaf and
+    // 0 if the key is not found
+    int getHeight(const Key &) const;
+
+    // height / size / isEmpty ----------------------------------------------
+    // height and Node count of the whole tree, and whether it has no Nodes
+    int height() const;
+    int size() const;
+    bool isEmpty() const;
+
+private:
+
+    // Node holding its key inline
+    struct Node {
+        Key key;                               // stored key
+        Node* left;                            // left subtree pointer
+        Node* right;                           // right subtree pointer
+        int height;                            // height of subtree, leaf is 1
+        int size;                              // number of Nodes in subtree
+
+        explicit Node(const Key &key)
+            : key(key), left(NULL), right(NULL), height(1), size(1) { }
+    };
+
+    typedef typename allocator_traits<Alloc>::template rebind_alloc<Node> NodeAlloc;
+    typedef allocator_traits<NodeAlloc> NodeTraits;
+
+    Node* root;                                // root of the tree
+    Compare compare;                           // ordering of keys
+    NodeAlloc alloc;                           // source of Nodes
+
+
+    // Utility functions //////////////////////////////////////////////
+
+    // newNode / deleteNode / deleteTree ------------------------------------
+    // allocate and construct a leaf Node holding a copy of the key, destroy
+    // and deallocate one Node, and iteratively deallocate a whole subtree
+    Node* newNode(const Key &);
+    void deleteNode(Node*);
+    void deleteTree(Node*);
+
+    // findNode -------------------------------------------------------------
+    // descends to the Node holding the key, or NULL
+    Node* findNode(const Key &) const;
+
+    // duplicateTree --------------------------------------------------------
+    // iteratively copies the subtree into this tree's Nodes, same shape. If
+    // a copy throws, the Nodes already copied are deallocated first
+    Node* duplicateTree(const Node*);
+
+    // fixPath --------------------------------------------------------------
+    // rebalances each link of a root-to-leaf path from the bottom up
+    static void fixPath(vector<Node**> &);
+
+    // nodeHeight / nodeSize / updateNode -----------------------------------
+    // cached height and size of a Node (0 if NULL), and recomputing both
+    // from the children
+    static int nodeHeight(const Node*);
+    static int nodeSize(const Node*);
+    static void updateNode(Node*);
+
+    // rotateLeft / rotateRight / rebalance ---------------------------------
+    // single rotations, and the update and rotation that restore the AVL
+    // property at one Node
+    static void rotateLeft(Node* &);
+    static void rotateRight(Node* &);
+    static void rebalance(Node* &);
+};
+
+
+// NodeDataTree ---------------------------------------------------------------
+// A BasicBinTree of NodeData held by value, ordered by NodeData::operator<
+
+typedef BasicBinTree<NodeData> NodeDataTree;
+
+
+// operator<< -----------------------------------------------------------------
+// Inorder with an explicit stack, each key followed by a space, then endl.
+
+template <class K, class C, class A>
+ostream& operator<<(ostream &out, const BasicBinTree<K, C, A> &outputTree) {
+    vector<const typename BasicBinTree<K, C, A>::Node*> pending;
+    const typename BasicBinTree<K, C, A>::Node* cur = outputTree.root;
+    while (cur != NULL || !pending.empty()) {
+        while (cur != NULL) {
+            pending.push_back(cur);
+            cur = cur->left;
+        }
+        cur = pending.back();
+        pending.pop_back();
+        out << cur->key << " ";
+        cur = cur->right;
+    }
+    out << endl;
+    return out;
+}
+
+
+// Constructors ///////////////////////////////////////////////////////////////
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>::BasicBinTree(const Compare &compare, const Alloc &alloc)
+    : root(NULL), compare(compare), alloc(alloc) {
+}
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>::BasicBinTree(const BasicBinTree &inputTree)
+    : root(NULL), compare(inputTree.compare),
+      alloc(NodeTraits::select_on_container_copy_construction(inputTree.alloc)) {
+    root = duplicateTree(inputTree.root);
+}
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>::BasicBinTree(BasicBinTree &&inputTree)
+    noexcept(is_nothrow_move_constructible<Compare>::value)
+    : root(inputTree.root), compare(std::move(inputTree.compare)),
+      alloc(std::move(inputTree.alloc)) {
+    inputTree.root = NULL;
+}
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>::~BasicBinTree() {
+    makeEmpty();
+}
+
+
+// Assignment Operators ///////////////////////////////////////////////////////
+// Copy assignment builds the copy in a temporary and swaps it in.
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>&
+BasicBinTree<Key, Compare, Alloc>::operator=(const BasicBinTree &rhsTree) {
+    if (this != &rhsTree) {         // avoid self-assignment by identity
+        BasicBinTree copy(rhsTree);
+        swap(copy);                 // old contents released with copy
+    }
+    return *this;
+}
+
+template <class Key, class Compare, class Alloc>
+BasicBinTree<Key, Compare, Alloc>&
+BasicBinTree<Key, Compare, Alloc>::operator=(BasicBinTree &&rhsTree)
+    noexcept(is_nothrow_move_constructible<Compare>::value
+             && is_nothrow_move_assignable<Compare>::value) {
+    if (this != &rhsTree) {
+        makeEmpty();
+        swap(rhsTree);
+    }
+    return *this;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::swap(BasicBinTree &otherTree)
+    noexcept(is_nothrow_move_constructible<Compare>::value
+             && is_nothrow_move_assignable<Compare>::value) {
+    std::swap(root, otherTree.root);
+    std::swap(compare, otherTree.compare);
+    std::swap(alloc, otherTree.alloc);
+}
+
+
+// Equality Operators /////////////////////////////////////////////////////////
+// Walks both trees in step with one stack of Node pairs.
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::operator==(const BasicBinTree &rhsTree) const {
+    vector<pair<const Node*, const Node*> > pending;
+    pending.push_back(make_pair(root, rhsTree.root));
+    while (!pending.empty()) {
+        const Node* lhs = pending.back().first;
+        const Node* rhs = pending.back().second;
+        pending.pop_back();
+        if (lhs == rhs) {                           // same Node, or both NULL
+            continue;
+        } else if (lhs == NULL || rhs == NULL) {    // differing shape
+            return false;
+        } else if (compare(lhs->key, rhs->key) || compare(rhs->key, lhs->key)) {
+            return false;                           // differing keys
+        }
+        pending.push_back(make_pair(lhs->right, rhs->right));
+        pending.push_back(make_pair(lhs->left, rhs->left));
+    }
+    return true;
+}
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::operator!=(const BasicBinTree &rhsTree) const {
+    return !(*this == rhsTree);
+}
+
+
+// Mutators ///////////////////////////////////////////////////////////////////
+
+// insert ---------------------------------------------------------------------
+// One comparison per level: going left whenever the Node is not less than
+// newKey leaves candidate at the smallest Node >= newKey, which is a
+// duplicate exactly when newKey is not less than it either.
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::insert(const Key &newKey) {
+    vector<Node**> path;                            // links from root downward
+    Node** link = &root;
+    Node* candidate = NULL;                         // smallest Node >= newKey
+    while (*link != NULL) {
+        path.push_back(link);
+        if (compare((*link)->key, newKey)) {        // smaller, newKey goes right
+            link = &(*link)->right;
+        } else {
+            candidate = *link;
+            link = &(*link)->left;
+        }
+    }
+    if (candidate != NULL && !compare(newKey, candidate->key)) {
+        return false;                               // already exists, so skips
+    }
+    *link = newNode(newKey);
+    fixPath(path);                                  // fix heights, sizes back up
+    return true;
+}
+
+// remove ---------------------------------------------------------------------
+// One comparison per level, as in insert: the descent runs to the bottom
+// remembering the link to the smallest Node >= target, then the path is cut
+// back to that link if its key is target. A Node with two children takes
+// its successor's key, and the successor's Node is spliced out instead.
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::remove(const Key &target) {
+    vector<Node**> path;                            // links from root downward
+    Node** link = &root;
+    Node** candidate = NULL;                        // link to smallest Node >= target
+    size_t above = 0;                               // links above candidate
+    while (*link != NULL) {
+        if (compare((*link)->key, target)) {        // smaller, target is right
+            path.push_back(link);
+            link = &(*link)->right;
+        } else {
+            candidate = link;
+            above = path.size();
+            path.push_back(link);
+            link = &(*link)->left;
+        }
+    }
+    if (candidate == NULL || compare(target, (*candidate)->key)) {
+        return false;                               // not in tree
+    }
+    path.resize(above);                             // links above the match
+    link = candidate;
+    Node* found = *link;
+    if (found->left != NULL && found->right != NULL) {
+        path.push_back(link);                       // find successor
+        link = &found->right;
+        while ((*link)->left != NULL) {
+            path.push_back(link);
+            link = &(*link)->left;
+        }
+        found->key = std::move((*link)->key);       // replace with successor
+    }
+    Node* doomed = *link;                           // zero or one child, splice
+    *link = (doomed->left != NULL) ? doomed->left : doomed->right;
+    deleteNode(doomed);
+    fixPath(path);
+    return true;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::makeEmpty() {
+    deleteTree(root);
+    root = NULL;
+}
+
+
+// Accessors //////////////////////////////////////////////////////////////////
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::retrieve(const Key &keyDesired,
+                                                 const Key* &keyRetrieved) const {
+    Node* found = findNode(keyDesired);
+    keyRetrieved = (found == NULL) ? NULL : &found->key;
+    return found != NULL;
+}
+
+template <class Key, class Compare, class Alloc>
+int BasicBinTree<Key, Compare, Alloc>::getHeight(const Key &keyDesired) const {
+    return nodeHeight(findNode(keyDesired));
+}
+
+template <class Key, class Compare, class Alloc>
+int BasicBinTree<Key, Compare, Alloc>::height() const {
+    return nodeHeight(root);
+}
+
+template <class Key, class Compare, class Alloc>
+int BasicBinTree<Key, Compare, Alloc>::size() const {
+    return nodeSize(root);
+}
+
+template <class Key, class Compare, class Alloc>
+bool BasicBinTree<Key, Compare, Alloc>::isEmpty() const {
+    return root == NULL;
+}
+
+
+// Utility functions //////////////////////////////////////////////////////////
+
+template <class Key, class Compare, class Alloc>
+typename BasicBinTree<Key, Compare, Alloc>::Node*
+BasicBinTree<Key, Compare, Alloc>::newNode(const Key &key) {
+    Node* fresh = NodeTraits::allocate(alloc, 1);
+    try {
+        NodeTraits::construct(alloc, fresh, key);
+    } catch (...) {
+        NodeTraits::deallocate(alloc, fresh, 1);
+        throw;
+    }
+    return fresh;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::deleteNode(Node* cur) {
+    NodeTraits::destroy(alloc, cur);
+    NodeTraits::deallocate(alloc, cur, 1);
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::deleteTree(Node* cur) {
+    vector<Node*> pending;
+    if (cur != NULL) {
+        pending.push_back(cur);
+    }
+    while (!pending.empty()) {
+        cur = pending.back();
+        pending.pop_back();
+        if (cur->left != NULL) {
+            pending.push_back(cur->left);
+        }
+        if (cur->right != NULL) {
+            pending.push_back(cur->right);
+        }
+        deleteNode(cur);
+    }
+}
+
+// findNode -------------------------------------------------------------------
+// Same single comparison per level as insert, checking equality once at the
+// bottom.
+
+template <class Key, class Compare, class Alloc>
+typename BasicBinTree<Key, Compare, Alloc>::Node*
+BasicBinTree<Key, Compare, Alloc>::findNode(const Key &key) const {
+    Node* cur = root;
+    Node* candidate = NULL;                         // smallest Node >= key
+    while (cur != NULL) {
+        if (compare(cur->key, key)) {
+            cur = cur->right;
+        } else {
+            candidate = cur;
+            cur = cur->left;
+        }
+    }
+    if (candidate != NULL && !compare(key, candidate->key)) {
+        return candidate;
+    }
+    return NULL;
+}
+
+// duplicateTree --------------------------------------------------------------
+// Builds the copy under a local root. Every link not yet filled is still
+// NULL, so if a Key copy or the allocator throws, the partial copy is a
+// whole tree that deleteTree can free before the exception goes on.
+
+template <class Key, class Compare, class Alloc>
+typename BasicBinTree<Key, Compare, Alloc>::Node*
+BasicBinTree<Key, Compare, Alloc>::duplicateTree(const Node* source) {
+    Node* copyRoot = NULL;
+    try {
+        vector<pair<Node**, const Node*> > pending;
+        pending.push_back(make_pair(&copyRoot, source));
+        while (!pending.empty()) {
+            Node** link = pending.back().first;
+            const Node* from = pending.back().second;
+            pending.pop_back();
+            if (from == NULL) {
+                continue;
+            }
+            *link = newNode(from->key);
+            (*link)->height = from->height;
+            (*link)->size = from->size;
+            pending.push_back(make_pair(&(*link)->right, from->right));
+            pending.push_back(make_pair(&(*link)->left, from->left));
+        }
+    } catch (...) {
+        deleteTree(copyRoot);
+        throw;
+    }
+    return copyRoot;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::fixPath(vector<Node**> &path) {
+    while (!path.empty()) {
+        rebalance(*path.back());
+        path.pop_back();
+    }
+}
+
+template <class Key, class Compare, class Alloc>
+int BasicBinTree<Key, Compare, Alloc>::nodeHeight(const Node* cur) {
+    return (cur == NULL) ? 0 : cur->height;
+}
+
+template <class Key, class Compare, class Alloc>
+int BasicBinTree<Key, Compare, Alloc>::nodeSize(const Node* cur) {
+    return (cur == NULL) ? 0 : cur->size;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::updateNode(Node* cur) {
+    cur->height = 1 + max(nodeHeight(cur->left), nodeHeight(cur->right));
+    cur->size = 1 + nodeSize(cur->left) + nodeSize(cur->right);
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::rotateLeft(Node* &cur) {
+    Node* pivot = cur->right;
+    cur->right = pivot->left;
+    pivot->left = cur;
+    updateNode(cur);
+    updateNode(pivot);
+    cur = pivot;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::rotateRight(Node* &cur) {
+    Node* pivot = cur->left;
+    cur->left = pivot->right;
+    pivot->right = cur;
+    updateNode(cur);
+    updateNode(pivot);
+    cur = pivot;
+}
+
+template <class Key, class Compare, class Alloc>
+void BasicBinTree<Key, Compare, Alloc>::rebalance(Node* &cur) {
+    updateNode(cur);
+    int balance = nodeHeight(cur->left) - nodeHeight(cur->right);
+    if (balance > 1) {                              // left heavy
+        if (nodeHeight(cur->left->left) < nodeHeight(cur->left->right)) {
+            rotateLeft(cur->left);                  // left-right case
+        }
+        rotateRight(cur);
+    } else if (balance < -1) {                      // right heavy
+        if (nodeHeight(cur->right->right) < nodeHeight(cur->right->left)) {
+            rotateRight(cur->right);                // right-left case
+        }
+        rotateLeft(cur);
+    }
+}
+
+#endif
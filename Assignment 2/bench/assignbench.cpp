@@ -0,0 +1,63 @@
+//
+//  assignbench.cpp
+//
+//  Benchmark for BinTree assignment, the T2 = T of lab2.cpp, at growing tree
+//  sizes. For each size it prints, in nanoseconds:
+//     assign   -- T2 = T, which shares T's Nodes as a snapshot
+//     equal    -- T2 = U for a U equal to T but built separately, which
+//                 copies all the same; no comparison pass is made
+//     compare  -- T == U, the full walk operator= no longer does
+//     write    -- T2 = T followed by one insert into T2, which copies only
+//                 the path the insert touches
+//     deep     -- BinTree(T, 1), an independent copy, and its cost per Node;
+//                 it grows with the tree only as the tree outgrows the caches
+//
+//  usage: assignbench [maxSize]    sizes run from 1000 up to maxSize (1e6)
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/assignbench.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o assignbench
+
+#include "benchutil.h"
+#include <iostream>
+#include <memory>
+using namespace std;
+
+const int REPEATS = 5;
+
+int main(int argc, char* argv[]) {
+    long maxSize = argOr(argc, argv, 1, 1000000);
+    printf("%10s %10s %10s %12s %10s %12s %9s\n", "n", "assign",
+           "equal", "compare", "write", "deep", "deep/n");
+    for (long n = 1000; n <= maxSize; n *= 10) {
+        BinTree tree(true), same(true), copy(true);
+        makeTree(tree, (int)n);
+        makeTree(same, (int)n);
+        NodeData probe("not-a-hex-key");
+
+        double assign = bestSeconds(REPEATS, [&]() { copy = tree; });
+        double equal = bestSeconds(REPEATS, [&]() { copy = same; });
+        bool equalTrees = false;
+        double compare = bestSeconds(REPEATS, [&]() {
+            equalTrees = (tree == same);
+        });
+        double write = bestSeconds(REPEATS, [&]() {
+            copy = tree;
+            copy.insert(new NodeData(probe));
+        });
+        unique_ptr<BinTree> kept[REPEATS];     // freed after timing
+        int made = 0;
+        double deep = bestSeconds(REPEATS, [&]() {
+            kept[made++].reset(new BinTree(tree, 1));
+        });
+        if (!equalTrees || copy.size() != n + 1) {
+            cerr << "assignbench: trees differ at n = " << n << endl;
+            return 1;
+        }
+
+        printf("%10ld %10.0f %10.0f %12.0f %10.0f %12.0f %9.1f\n", n,
+               assign * 1e9, equal * 1e9, compare * 1e9, write * 1e9,
+               deep * 1e9, deep * 1e9 / n);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+//
+//  batchbench.cpp
+//
+//  Benchmark for BinTree::retrieveBatch against a loop of single retrieve
+//  calls, at 1e4 keys and every power of ten up to maxSize, in batches of
+//  16, 256 and 4096 probes. For each it prints nanoseconds per key both
+//  ways and the speed-up of the batch, and checks both find the same
+//  NodeData. Probes are three quarters hits, in random order.
+//
+//  usage: batchbench [maxSize [probes]]    defaults 1e6 keys, 1e6 probes
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/batchbench.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o batchbench
+
+#include "benchutil.h"
+#include <iostream>
+using namespace std;
+
+const int REPEATS = 3;
+const int BATCH_SIZES[] = { 16, 256, 4096 };
+
+int main(int argc, char* argv[]) {
+    long maxSize = argOr(argc, argv, 1, 1000000);
+    int probeCount = (int)argOr(argc, argv, 2, 1000000);
+    printf("%10s %6s %10s %10s %8s\n", "n", "batch", "loop", "batch",
+           "speedup");
+    for (long n = 10000; n <= maxSize; n *= 10) {
+        BinTree tree(true);
+        makeTree(tree, (int)n);
+        const BinTree &reader = tree;
+
+        vector<NodeData> probes;
+        probes.reserve(probeCount);
+        for (int i = 0; i < probeCount; i++) {
+            unsigned long long pick = mixKey(i) % n;
+            probes.push_back(NodeData(makeKey(i % 4 ? pick : n + pick)));
+        }
+        vector<const NodeData*> single(probeCount), batched(probeCount);
+
+        double loop = bestSeconds(REPEATS, [&]() {
+            for (int i = 0; i < probeCount; i++) {
+                if (!reader.retrieve(probes[i], single[i])) {
+                    single[i] = NULL;
+                }
+            }
+        });
+        for (size_t b = 0; b < sizeof(BATCH_SIZES) / sizeof(int); b++) {
+            int batch = BATCH_SIZES[b];
+            double batchTime = bestSeconds(REPEATS, [&]() {
+                for (int i = 0; i < probeCount; i += batch) {
+                    reader.retrieveBatch(&probes[i],
+                                         min(batch, probeCount - i),
+                                         &batched[i]);
+                }
+            });
+            if (batched != single) {
+                cerr << "batchbench: batch and loop disagree at n = " << n
+                     << endl;
+                return 1;
+            }
+            printf("%10ld %6d %10.1f %10.1f %8.2f\n", n, batch,
+                   loop * 1e9 / probeCount, batchTime * 1e9 / probeCount,
+                   loop / batchTime);
+        }
+    }
+    return 0;
+}
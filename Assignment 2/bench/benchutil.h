@@ -0,0 +1,95 @@
+//
+//  benchutil.h
+//
+//  Helpers shared by the benchmark drivers in this directory: a wall-clock
+//  timer, distinct pseudo-random keys, and balanced BinTrees of a given size
+//  built from them. Each driver is its own program with its own main, like
+//  lab2.cpp, and is built from the "Assignment 2" directory, e.g.
+//
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/assignbench.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o assignbench
+//
+//  Assumptions:
+//     -- Timings are wall-clock and the best of several runs, so they are
+//        only comparable between runs on the same idle machine
+//     -- Keys are the same on every run, so results can be reproduced
+
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+#include "bintree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// mixKey: a bijection on 64-bit values, so distinct i give distinct keys
+inline unsigned long long mixKey(unsigned long long i) {
+    i += 0x9E3779B97F4A7C15ULL;
+    i = (i ^ (i >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    i = (i ^ (i >> 27)) * 0x94D049BB133111EBULL;
+    return i ^ (i >> 31);
+}
+
+// makeKey: the i-th key, 16 hex digits in an order unrelated to i
+inline string makeKey(unsigned long long i) {
+    char text[17];
+    snprintf(text, sizeof(text), "%016llx", mixKey(i));
+    return string(text, 16);
+}
+
+// urlKey: the i-th key as a URL path, all sharing a long common prefix
+inline string urlKey(unsigned long long i) {
+    return "https://www.example.com/catalog/products/category/item-"
+           + makeKey(i);
+}
+
+// makeTree: empties tree and fills it with keys 0 .. n - 1 of keyFor,
+// deleting any key keyFor repeats
+template <class KeyFor>
+void makeTree(BinTree &tree, int n, KeyFor keyFor) {
+    vector<NodeData*> items;
+    items.reserve(n);
+    for (int i = 0; i < n; i++) {
+        items.push_back(new NodeData(keyFor(i)));
+    }
+    tree.bulkLoad(items, false);
+    for (size_t i = 0; i < items.size(); i++) {
+        delete items[i];                       // duplicates stay with us
+    }
+}
+
+inline void makeTree(BinTree &tree, int n) {
+    makeTree(tree, n, makeKey);
+}
+
+// bestSeconds: shortest wall-clock time of repeats calls to work
+template <class Work>
+double bestSeconds(int repeats, Work work) {
+    double best = 0;
+    for (int r = 0; r < repeats; r++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        work();
+        chrono::duration<double> took = chrono::steady_clock::now() - start;
+        if (r == 0 || took.count() < best) {
+            best = took.count();
+        }
+    }
+    return best;
+}
+
+// argOr: argv[index] as a number, or fallback if it is not given
+inline long argOr(int argc, char* argv[], int index, long fallback) {
+    return index < argc ? atol(argv[index]) : fallback;
+}
+
+// coreCount: number of hardware threads, at least 1
+inline int coreCount() {
+    int cores = (int)thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+#endif
@@ -0,0 +1,119 @@
+//
+//  comparebench.cpp
+//
+//  Comparison-count benchmark for BinTree descents, run on URL-path keys
+//  that share a 56-character prefix and, for contrast, on short keys. Built
+//  with -DNODEDATA_COUNT_COMPARES so NodeData counts every comparison. For
+//  each kind of key it prints the tree height, the NodeData comparisons per
+//  retrieve, insert and remove, which stay at one per level visited, and
+//  nanoseconds per retrieve. It then times one tree level both ways on
+//  keys that differ only after the shared prefix: one three-way compare,
+//  against the == followed by < the descents used to make.
+//
+//  usage: comparebench [size [probes]]    defaults 1e5 keys, 1e5 probes
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -DNODEDATA_COUNT_COMPARES -I.
+//         bench/comparebench.cpp bintree.cpp mappedbintree.cpp nodedata.cpp
+//         -o comparebench
+
+#include "benchutil.h"
+#include <cmath>
+#include <iostream>
+using namespace std;
+
+#ifndef NODEDATA_COUNT_COMPARES
+#error "comparebench must be built with -DNODEDATA_COUNT_COMPARES"
+#endif
+
+const int REPEATS = 3;
+
+// perOp: comparisons made by work, divided by count
+template <class Work>
+double perOp(int count, Work work) {
+    nodeDataCompares = 0;
+    work();
+    return (double)nodeDataCompares / count;
+}
+
+// runKeys: counts and times the descents on a tree of n keys from keyFor
+template <class KeyFor>
+void runKeys(const char* name, int n, int probeCount, KeyFor keyFor) {
+    BinTree tree(true);
+    makeTree(tree, n, keyFor);
+    vector<NodeData> hits, misses;
+    for (int i = 0; i < probeCount; i++) {
+        hits.push_back(NodeData(keyFor(mixKey(i) % n)));
+        misses.push_back(NodeData(keyFor(n + i)));
+    }
+
+    const BinTree &reader = tree;
+    int found = 0;
+    double retrieves = perOp(probeCount, [&]() {
+        for (int i = 0; i < probeCount; i++) {
+            const NodeData* data;
+            found += reader.retrieve(hits[i], data);
+        }
+    });
+    double inserts = perOp(probeCount, [&]() {
+        for (int i = 0; i < probeCount; i++) {
+            tree.insert(new NodeData(misses[i]));
+        }
+    });
+    double removes = perOp(probeCount, [&]() {
+        for (int i = 0; i < probeCount; i++) {
+            tree.remove(misses[i]);
+        }
+    });
+    double seconds = bestSeconds(REPEATS, [&]() {
+        for (int i = 0; i < probeCount; i++) {
+            const NodeData* data;
+            found += reader.retrieve(hits[i], data);
+        }
+    });
+    if (found != probeCount * (REPEATS + 1) || tree.size() != n) {
+        cerr << "comparebench: lookups went wrong for " << name << endl;
+        exit(1);
+    }
+
+    printf("%-6s %8d %7d %8.1f %9.2f %8.2f %8.2f %10.1f\n", name, n,
+           tree.height(), log2((double)n), retrieves, inserts, removes,
+           seconds * 1e9 / probeCount);
+}
+
+int main(int argc, char* argv[]) {
+    int n = (int)argOr(argc, argv, 1, 100000);
+    int probeCount = (int)argOr(argc, argv, 2, 100000);
+
+    printf("%-6s %8s %7s %8s %9s %8s %8s %10s\n", "keys", "n", "height",
+           "log2 n", "retrieve", "insert", "remove", "ns/lookup");
+    runKeys("url", n, probeCount, urlKey);
+    runKeys("short", n, probeCount, makeKey);
+
+    // one level of a descent, on keys equal up to their last characters
+    vector<NodeData> keys;
+    for (int i = 0; i < 1024; i++) {
+        keys.push_back(NodeData(urlKey(i)));
+    }
+    long sign = 0;
+    double threeWay = bestSeconds(REPEATS, [&]() {
+        for (int r = 0; r < 1000; r++) {
+            for (int i = 0; i < 1024; i++) {
+                sign += keys[i].compare(keys[(i * 7 + r) & 1023]) < 0;
+            }
+        }
+    });
+    double twoCompares = bestSeconds(REPEATS, [&]() {
+        for (int r = 0; r < 1000; r++) {
+            for (int i = 0; i < 1024; i++) {
+                const NodeData &other = keys[(i * 7 + r) & 1023];
+                sign += !(keys[i] == other) && keys[i] < other;
+            }
+        }
+    });
+    volatile long sink = sign;                 // keeps both loops
+    (void)sink;
+    printf("\nper level on url keys: compare() %.1f ns, == then < %.1f ns\n",
+           threeWay * 1e9 / 1024000, twoCompares * 1e9 / 1024000);
+    return 0;
+}
@@ -0,0 +1,88 @@
+//
+//  frozenbench.cpp
+//
+//  Benchmark for FrozenBinTree against the pointer-based BinTree it was
+//  frozen from, at 1e4 keys and every power of ten up to maxSize. For each
+//  size it prints nanoseconds per lookup of random keys for retrieve (half
+//  hits, half misses) and for lower_bound on both trees, and the speed-up
+//  of the frozen layout.
+//
+//  usage: frozenbench [maxSize [probes]]    defaults 1e6 keys, 1e6 probes
+//         1e8 keys needs roughly 20 GB, as both trees are held at once
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/frozenbench.cpp
+//         frozenbintree.cpp bintree.cpp mappedbintree.cpp nodedata.cpp
+//         -o frozenbench
+
+#include "benchutil.h"
+#include "frozenbintree.h"
+#include <iostream>
+using namespace std;
+
+const int REPEATS = 3;
+
+int main(int argc, char* argv[]) {
+    long maxSize = argOr(argc, argv, 1, 1000000);
+    int probeCount = (int)argOr(argc, argv, 2, 1000000);
+    printf("%10s %10s %10s %8s %10s %10s %8s\n", "n", "pointer", "frozen",
+           "speedup", "ptr lower", "frz lower", "speedup");
+    for (long n = 10000; n <= maxSize; n *= 10) {
+        BinTree pointer(true), toFreeze(true);
+        makeTree(pointer, (int)n);
+        makeTree(toFreeze, (int)n);
+        FrozenBinTree frozen(toFreeze);
+
+        // odd probes are keys the trees hold, even probes are keys they lack
+        vector<NodeData> probes;
+        probes.reserve(probeCount);
+        for (int i = 0; i < probeCount; i++) {
+            unsigned long long pick = mixKey(i) % n;
+            probes.push_back(NodeData(makeKey(i % 2 ? pick : n + pick)));
+        }
+
+        const BinTree &reader = pointer;
+        int pointerHits = 0, frozenHits = 0;
+        double pointerTime = bestSeconds(REPEATS, [&]() {
+            pointerHits = 0;
+            for (int i = 0; i < probeCount; i++) {
+                const NodeData* found;
+                pointerHits += reader.retrieve(probes[i], found);
+            }
+        });
+        double frozenTime = bestSeconds(REPEATS, [&]() {
+            frozenHits = 0;
+            for (int i = 0; i < probeCount; i++) {
+                NodeData* found;
+                frozenHits += frozen.retrieve(probes[i], found);
+            }
+        });
+
+        // lower_bound results are summed so neither loop can be skipped
+        size_t pointerSum = 0, frozenSum = 0;
+        double pointerLower = bestSeconds(REPEATS, [&]() {
+            pointerSum = 0;
+            for (int i = 0; i < probeCount; i++) {
+                BinTree::const_iterator it = reader.lower_bound(probes[i]);
+                pointerSum += it == reader.end() ? 0 : it->getData().size();
+            }
+        });
+        double frozenLower = bestSeconds(REPEATS, [&]() {
+            frozenSum = 0;
+            for (int i = 0; i < probeCount; i++) {
+                const NodeData* found = frozen.lower_bound(probes[i]);
+                frozenSum += found == NULL ? 0 : found->getData().size();
+            }
+        });
+        if (pointerHits != frozenHits || pointerSum != frozenSum) {
+            cerr << "frozenbench: trees disagree at n = " << n << endl;
+            return 1;
+        }
+
+        printf("%10ld %10.1f %10.1f %8.2f %10.1f %10.1f %8.2f\n", n,
+               pointerTime * 1e9 / probeCount, frozenTime * 1e9 / probeCount,
+               pointerTime / frozenTime, pointerLower * 1e9 / probeCount,
+               frozenLower * 1e9 / probeCount, pointerLower / frozenLower);
+    }
+    return 0;
+}
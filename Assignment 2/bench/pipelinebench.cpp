@@ -0,0 +1,74 @@
+//
+//  pipelinebench.cpp
+//
+//  Throughput benchmark for TreePipeline. It generates lines independent
+//  "$$"-terminated trees of random words in memory, runs lab2's tests on
+//  them with 1 worker up to maxWorkers, and prints lines per second and the
+//  speed-up over one worker. Every run's output must match the one-worker
+//  output byte for byte.
+//
+//  usage: pipelinebench [lines [maxWorkers [words]]]
+//         defaults 20000 lines, every core, 20 words per line
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/pipelinebench.cpp
+//         treepipeline.cpp treetokenizer.cpp bintree.cpp mappedbintree.cpp
+//         nodedata.cpp -o pipelinebench
+
+#include "benchutil.h"
+#include "treepipeline.h"
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+const int REPEATS = 3;
+
+int main(int argc, char* argv[]) {
+    int lines = (int)argOr(argc, argv, 1, 20000);
+    int maxWorkers = (int)argOr(argc, argv, 2, coreCount());
+    int words = (int)argOr(argc, argv, 3, 20);
+
+    // short words from a small alphabet, so lines repeat some of them and
+    // lab2's retrieve and height checks sometimes find what they look for
+    string input;
+    unsigned long long state = 1;
+    for (int line = 0; line < lines; line++) {
+        for (int w = 0; w < words; w++) {
+            state = mixKey(state);
+            int length = 1 + (int)(state % 4);
+            for (int c = 0; c < length; c++) {
+                input += (char)('a' + (state >> (8 * c + 8)) % 26);
+            }
+            input += ' ';
+        }
+        input += "$$\n";
+    }
+
+    printf("%d lines of %d words, %d cores\n", lines, words, coreCount());
+    printf("%8s %12s %8s\n", "workers", "lines/s", "speedup");
+    string expected;
+    double oneWorker = 0;
+    for (int workers = 1; workers <= maxWorkers; workers++) {
+        string output;
+        double seconds = bestSeconds(REPEATS, [&]() {
+            istringstream in(input);
+            ostringstream out;
+            if (TreePipeline(workers).run(in, out) != lines) {
+                cerr << "pipelinebench: lines went missing" << endl;
+                exit(1);
+            }
+            output = out.str();
+        });
+        if (workers == 1) {
+            expected = output;
+            oneWorker = seconds;
+        } else if (output != expected) {
+            cerr << "pipelinebench: output with " << workers
+                 << " workers differs from one worker" << endl;
+            return 1;
+        }
+        printf("%8d %12.0f %8.2f\n", workers, lines / seconds,
+               oneWorker / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+//
+//  readerbench.cpp
+//
+//  Read/write throughput benchmark for ConcurrentBinTree against a BinTree
+//  behind one global mutex, the way the service guards it today. For 1 up
+//  to maxReaders reader threads, each run preloads the tree, then lets the
+//  readers retrieve random preloaded keys while one writer inserts new keys
+//  for a fixed time. It prints millions of reads and thousands of writes
+//  per second for both trees, and how read throughput scales with readers.
+//
+//  usage: readerbench [size [maxReaders [seconds]]]
+//         defaults 1e5 preloaded keys, the larger of 4 and the core count,
+//         and 0.5 seconds per run
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/readerbench.cpp
+//         concurrentbintree.cpp bintree.cpp mappedbintree.cpp nodedata.cpp
+//         -o readerbench
+
+#include "benchutil.h"
+#include "concurrentbintree.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+using namespace std;
+
+// Operations each side managed during one timed run
+struct Throughput {
+    double reads;                              // retrieves per second
+    double writes;                             // inserts per second
+};
+
+// measure: runs readers threads calling read(i) and one thread calling
+// write(i) for the given time; read returns false if a key was missed
+template <class Read, class Write>
+Throughput measure(int readers, int n, double seconds, Read read,
+                   Write write) {
+    atomic<bool> stop(false);
+    atomic<long> reads(0), misses(0);
+    long writes = 0;
+    vector<thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.push_back(thread([&, r]() {
+            unsigned long long state = mixKey(r + 1);
+            long done = 0, missed = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                state = mixKey(state);
+                if (!read((int)(state % n))) {
+                    missed++;
+                }
+                done++;
+            }
+            reads += done;
+            misses += missed;
+        }));
+    }
+    threads.push_back(thread([&]() {
+        while (!stop.load(memory_order_relaxed)) {
+            write(n + writes++);
+        }
+    }));
+
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop = true;
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    if (misses != 0) {
+        cerr << "readerbench: " << misses << " preloaded keys missed" << endl;
+        exit(1);
+    }
+    Throughput result = { reads / seconds, writes / seconds };
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int n = (int)argOr(argc, argv, 1, 100000);
+    int maxReaders = (int)argOr(argc, argv, 2, max(4, coreCount()));
+    double seconds = argc > 3 ? atof(argv[3]) : 0.5;
+
+    // probe keys are made up front so readers only search
+    vector<NodeData> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; i++) {
+        keys.push_back(NodeData(makeKey(i)));
+    }
+
+    printf("%d keys, %d cores\n", n, coreCount());
+    printf("%8s %12s %10s %8s %12s %10s\n", "readers", "lockfree M/s",
+           "writes k/s", "scaling", "mutex M/s", "writes k/s");
+    double firstReads = 0;
+    for (int readers = 1; readers <= maxReaders; readers++) {
+        ConcurrentBinTree concurrent;
+        for (int i = 0; i < n; i++) {
+            concurrent.insert(new NodeData(keys[i]));
+        }
+        Throughput lockFree = measure(readers, n, seconds,
+            [&](int i) {
+                const NodeData* found;
+                return concurrent.retrieve(keys[i], found);
+            },
+            [&](long i) { concurrent.insert(new NodeData(makeKey(i))); });
+
+        BinTree guarded(true);
+        makeTree(guarded, n);
+        mutex globalLock;
+        Throughput locked = measure(readers, n, seconds,
+            [&](int i) {
+                lock_guard<mutex> lock(globalLock);
+                const NodeData* found;
+                return static_cast<const BinTree &>(guarded)
+                    .retrieve(keys[i], found);
+            },
+            [&](long i) {
+                lock_guard<mutex> lock(globalLock);
+                guarded.insert(new NodeData(makeKey(i)));
+            });
+
+        if (readers == 1) {
+            firstReads = lockFree.reads;
+        }
+        printf("%8d %12.2f %10.1f %8.2f %12.2f %10.1f\n", readers,
+               lockFree.reads / 1e6, lockFree.writes / 1e3,
+               lockFree.reads / firstReads, locked.reads / 1e6,
+               locked.writes / 1e3);
+    }
+    return 0;
+}
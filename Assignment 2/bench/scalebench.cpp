@@ -0,0 +1,61 @@
+//
+//  scalebench.cpp
+//
+//  Scaling benchmark for the parallel deep copy BinTree(T, threads) and the
+//  parallel makeEmpty(threads), run with 1 thread up to one per core. For
+//  each thread count it prints the milliseconds each takes and the speed-up
+//  over one thread, and checks that every copy equals the original.
+//
+//  usage: scalebench [size [maxThreads]]    defaults 1e6 Nodes, every core
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/scalebench.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o scalebench
+
+#include "benchutil.h"
+#include <iostream>
+#include <memory>
+using namespace std;
+
+const int REPEATS = 3;
+
+int main(int argc, char* argv[]) {
+    int n = (int)argOr(argc, argv, 1, 1000000);
+    int maxThreads = (int)argOr(argc, argv, 2, coreCount());
+    BinTree tree(true);
+    makeTree(tree, n);
+
+    printf("%d Nodes, %d cores\n", n, coreCount());
+    printf("%8s %10s %8s %12s %8s\n", "threads", "copy ms", "speedup",
+           "empty ms", "speedup");
+    double copyOne = 0, emptyOne = 0;
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        unique_ptr<BinTree> copy;
+        double copying = bestSeconds(REPEATS, [&]() {
+            copy.reset(new BinTree(tree, threads));
+        });
+        if (*copy != tree) {
+            cerr << "scalebench: copy differs with " << threads
+                 << " threads" << endl;
+            return 1;
+        }
+
+        // each run empties a fresh copy made outside the timed part
+        double emptying = 0;
+        for (int r = 0; r < REPEATS; r++) {
+            BinTree doomed(tree, maxThreads);
+            double took = bestSeconds(1, [&]() { doomed.makeEmpty(threads); });
+            if (r == 0 || took < emptying) {
+                emptying = took;
+            }
+        }
+
+        if (threads == 1) {
+            copyOne = copying;
+            emptyOne = emptying;
+        }
+        printf("%8d %10.1f %8.2f %12.1f %8.2f\n", threads, copying * 1e3,
+               copyOne / copying, emptying * 1e3, emptyOne / emptying);
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+//
+//  setbench.cpp
+//
+//  Benchmark for BinTree::unite, intersect and subtract. The first table
+//  combines a huge tree with small ones of 10 up to 1e5 keys, half of them
+//  also in the huge tree, and times the join-based operation against
+//  flattening both trees, merging the arrays on one thread and building the
+//  result tree from them, the way the hourly reconcile did it. The second
+//  table combines two large trees that share half their keys, with 1 thread
+//  up to maxThreads, and prints the speed-up over one thread. Each timed
+//  operation works on an independent copy made before the clock starts, and
+//  every result's size is checked against the merge.
+//
+//  usage: setbench [size [maxThreads]]    defaults 1e6 keys, every core
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O2 -pthread -I. bench/setbench.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o setbench
+
+#include "benchutil.h"
+#include <iostream>
+#include <iterator>
+#include <memory>
+using namespace std;
+
+const int REPEATS = 3;
+const char* const NAMES[] = { "unite", "intersect", "subtract" };
+
+// PointerLess: orders NodeData* by the NodeData they point to
+struct PointerLess {
+    bool operator()(const NodeData* lhs, const NodeData* rhs) const {
+        return *lhs < *rhs;
+    }
+};
+
+// combine: applies operation 0, 1 or 2 of NAMES to tree
+void combine(BinTree &tree, const BinTree &other, int operation,
+             int threads) {
+    switch (operation) {
+    case 0:  tree.unite(other, threads);      break;
+    case 1:  tree.intersect(other, threads);  break;
+    default: tree.subtract(other, threads);   break;
+    }
+}
+
+// timeCombine: best time of operation on a fresh copy of lhs, setting
+// resultSize to the size of the result
+double timeCombine(const BinTree &lhs, const BinTree &rhs, int operation,
+                   int threads, int &resultSize) {
+    double best = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        unique_ptr<BinTree> work(new BinTree(lhs, coreCount()));
+        double took = bestSeconds(1, [&]() {
+            combine(*work, rhs, operation, threads);
+        });
+        resultSize = work->size();
+        if (r == 0 || took < best) {
+            best = took;
+        }
+    }
+    return best;
+}
+
+// mergeInto: flattens both trees, merges them as operation would and builds
+// result from copies of the merged NodeData
+void mergeInto(const BinTree &lhs, const BinTree &rhs, int operation,
+               BinTree &result) {
+    vector<const NodeData*> left, right, merged;
+    for (BinTree::const_iterator it = lhs.begin(); it != lhs.end(); ++it) {
+        left.push_back(&*it);
+    }
+    for (BinTree::const_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+        right.push_back(&*it);
+    }
+    back_insert_iterator<vector<const NodeData*> > out(merged);
+    switch (operation) {
+    case 0:
+        set_union(left.begin(), left.end(), right.begin(), right.end(), out,
+                  PointerLess());
+        break;
+    case 1:
+        set_intersection(left.begin(), left.end(), right.begin(), right.end(),
+                         out, PointerLess());
+        break;
+    default:
+        set_difference(left.begin(), left.end(), right.begin(), right.end(),
+                       out, PointerLess());
+        break;
+    }
+    vector<NodeData*> copies;
+    copies.reserve(merged.size());
+    for (size_t i = 0; i < merged.size(); i++) {
+        copies.push_back(new NodeData(*merged[i]));
+    }
+    result.bulkLoad(copies);
+}
+
+// check: stops with a message if the two sizes differ
+void check(int treeSize, int mergedSize, const char* what) {
+    if (treeSize != mergedSize) {
+        cerr << "setbench: " << what << " gives " << treeSize
+             << " NodeData, the merge " << mergedSize << endl;
+        exit(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int n = (int)argOr(argc, argv, 1, 1000000);
+    int maxThreads = (int)argOr(argc, argv, 2, coreCount());
+    BinTree huge(true);
+    makeTree(huge, n);
+
+    printf("small against %d keys, ms\n", n);
+    printf("%10s %10s %10s %10s %8s\n", "small", "operation", "join",
+           "merge", "speedup");
+    for (int m = 10; m <= 100000 && m <= n; m *= 100) {
+        BinTree small(true);
+        makeTree(small, m, [n](int i) {
+            return makeKey(i % 2 ? mixKey(i) % n : n + i);
+        });
+        for (int operation = 0; operation < 3; operation++) {
+            // intersecting changes the small tree, so the Nodes of the huge
+            // one that cannot be in the result are never visited or freed
+            int joined = 0;
+            double join = operation == 1
+                ? timeCombine(small, huge, operation, 1, joined)
+                : timeCombine(huge, small, operation, 1, joined);
+            BinTree merged(true);
+            double merge = bestSeconds(REPEATS, [&]() {
+                mergeInto(huge, small, operation, merged);
+            });
+            check(joined, merged.size(), NAMES[operation]);
+            printf("%10d %10s %10.3f %10.1f %8.2f\n", m, NAMES[operation],
+                   join * 1e3, merge * 1e3, merge / join);
+        }
+    }
+
+    BinTree lhs(true), rhs(true);
+    makeTree(lhs, n);
+    makeTree(rhs, n, [n](int i) { return makeKey(n / 2 + i); });
+    printf("\ntwo trees of %d keys sharing half, %d cores, ms\n", n,
+           coreCount());
+    printf("%8s %10s %10s %8s\n", "threads", "operation", "join",
+           "speedup");
+    double oneThread[3] = { 0, 0, 0 };
+    for (int operation = 0; operation < 3; operation++) {
+        BinTree merged(true);
+        mergeInto(lhs, rhs, operation, merged);
+        for (int threads = 1; threads <= maxThreads; threads++) {
+            int joined = 0;
+            double best = timeCombine(lhs, rhs, operation, threads, joined);
+            check(joined, merged.size(), NAMES[operation]);
+            if (threads == 1) {
+                oneThread[operation] = best;
+            }
+            printf("%8d %10s %10.1f %8.2f\n", threads, NAMES[operation],
+                   best * 1e3, oneThread[operation] / best);
+        }
+    }
+    return 0;
+}
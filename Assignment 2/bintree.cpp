@@ -13,10 +13,17 @@
 //  Assumptions:
 //     -- Input assumed to be correct and consist of NodeData objects, to be
 //        implemented by client
-//     -- BSTs and arrays produced are assumed to be no more than 100 nodes,
-//        and any index not referencing a BinTree node should be NULL
+//     -- Arrays given to bstreeToArray must have room for every Node of the
+//        tree; the single-argument arrayToBSTree reads 100 slots, and any
+//        index not referencing a BinTree node should be NULL
 
 #include "bintree.h"
+#include "mappedbintree.h"
+#include "outputbuffer.h"
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <thread>
 using namespace std;
 
 
@@ -24,11 +31,11 @@ using namespace std;
  * operator<< --------------------------------------------------------------------------------------------------------------------------------------
  * overloaded operator<< : Prints an inorder traversal of the tree
  * pre: none
- * post: prints the outputTree as an inorder traversal
+ * post: prints the outputTree as an inorder traversal to out, followed by endl
  */
 
 ostream& operator<<(ostream & out, const BinTree &outputTree) {
-    outputTree.inorderHelper(outputTree.root);
+    outputTree.inorderHelper(out);
     out << endl;
     return out;
 }
@@ -36,16 +43,17 @@ ostream& operator<<(ostream & out, const BinTree &outputTree) {
 
 /**
  * inorderHelper -----------------------------------------------------------------------------------------------------------------------------------
- * inorderHelper : helper for operator<< overloaded method by recursively moving through the BinTree
+ * inorderHelper : helper for operator<< overloaded method by iterating through the BinTree. The text is gathered in
+ * an OutputBuffer and written to out in large blocks, rather than formatted into out one NodeData at a time.
  * pre: none
- * post: prints the outputTree as an inorder traversal
+ * post: prints the outputTree as an inorder traversal to out, each NodeData followed by a space
  */
     
-void BinTree::inorderHelper(Node* cur) const {
-    if (cur != NULL) {             // base case
-        inorderHelper(cur->left);
-        cout << *cur->data << " "; // performs inorder traversal
-        inorderHelper(cur->right);
+void BinTree::inorderHelper(ostream &out) const {
+    OutputBuffer buffer(out);
+    for (const_iterator it = begin(); it != end(); ++it) {
+        it->appendTo(buffer);          // performs inorder traversal
+        buffer.append(' ');
     }
 }
     
@@ -60,17 +68,70 @@ void BinTree::inorderHelper(Node* cur) const {
     
 BinTree::BinTree() {
     this->root = NULL;
+    this->balanced = false;
+    this->concurrent = false;
+}
+
+
+/**
+ * BinTree -----------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : creates an empty BinTree and sets root to NULL, choosing whether the tree rebalances itself
+ *
+ * @param balanced : true if insert and remove should keep the tree AVL balanced
+ */
+
+BinTree::BinTree(bool balanced) {
+    this->root = NULL;
+    this->balanced = balanced;
+    this->concurrent = false;
 }
 
     
 /**
  * BinTree -------------------------------------------------------------------------------------------------------------------------------------------
- * Copy Constructor : creates a BinTree and creates a deep copy of the inputTree, setting it to this
+ * Copy Constructor : creates a BinTree holding a snapshot of inputTree in O(1). The two trees share every Node
+ * and the pool they came from; a later insert or remove on either one copies the shared Nodes on its own path.
  */
 
 BinTree::BinTree(const BinTree &inputTree) {
+    this->root = share(inputTree.root);
+    this->balanced = inputTree.balanced;
+    this->concurrent = false;
+    if (inputTree.root != NULL) {
+        this->pool = inputTree.pool;
+    }
+}
+
+
+/**
+ * BinTree -------------------------------------------------------------------------------------------------------------------------------------------
+ * Copy Constructor : creates a BinTree and creates a deep copy of the inputTree using up to threads threads. Nothing
+ * is shared with inputTree, so neither tree ever copies on the other's behalf.
+ *
+ * @param inputTree : BinTree object to be copied
+ * @param threads : most threads to use, including the calling thread; 1 copies serially
+ */
+
+BinTree::BinTree(const BinTree &inputTree, int threads) {
+    this->root = NULL;
+    this->balanced = inputTree.balanced;
+    this->concurrent = false;
+    this->pool = make_shared<NodePool>();
+    duplicateParallel(this->root, inputTree.root, *pool, threads);
+}
+
+
+/**
+ * BinTree -------------------------------------------------------------------------------------------------------------------------------------------
+ * Move Constructor : takes over the Nodes, NodeData and balancing mode of inputTree without copying, leaving
+ * inputTree empty
+ */
+
+BinTree::BinTree(BinTree &&inputTree) noexcept {
     this->root = NULL;
-    *this = inputTree;
+    this->balanced = inputTree.balanced;
+    this->concurrent = false;
+    swap(inputTree);
 }
 
 
@@ -88,45 +149,144 @@ BinTree::~BinTree() {
 
 /**
  * operator= ------------------------------------------------------------------------------------------------------------------------------------
- * overloaded =: true if this BinTree != parameter BinTree, false if not
+ * overloaded =: makes this a snapshot of rhsTree. The snapshot is taken in a temporary in O(1) and then swapped
+ * in, so no Nodes are copied and nothing of the two trees is compared.
  *
  * @param rhsTree : BinTree object to be copied
  * pre: none
- * post: Provides a deep copy of the parameter BinTree and sets to rhs of this
+ * post: this shares the Nodes of rhsTree, and what this held before is released
  * @return: this reference to new BinTree
  */
     
 BinTree& BinTree::operator=(const BinTree &rhsTree) {
-    if (*this != rhsTree) {         // avoid self-assignment
+    if (this != &rhsTree) {         // avoid self-assignment by identity
+        BinTree copy(rhsTree);
+        swap(copy);                 // old contents released with copy
+    }
+    return *this;
+}
+
+
+/**
+ * operator= ------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded move =: deallocates this tree, then takes over the Nodes of rhsTree in O(1)
+ *
+ * @param rhsTree : BinTree object to be moved from
+ * pre: none
+ * post: this holds what rhsTree held, and rhsTree is empty
+ * @return: this reference to new BinTree
+ */
+
+BinTree& BinTree::operator=(BinTree &&rhsTree) noexcept {
+    if (this != &rhsTree) {         // avoid self-assignment
         makeEmpty();
-        duplicateTree(this->root, rhsTree.root);
+        swap(rhsTree);
     }
     return *this;
 }
 
 
+/**
+ * swap -----------------------------------------------------------------------------------------------------------------------------------------
+ * swap : exchanges the contents of this BinTree and otherTree, including their Node slabs, in O(1)
+ *
+ * @param otherTree : BinTree object to trade contents with
+ * pre: none
+ * post: each tree holds what the other held before, and iterators follow their Nodes to the other tree
+ */
+
+void BinTree::swap(BinTree &otherTree) noexcept {
+    std::swap(root, otherTree.root);
+    std::swap(balanced, otherTree.balanced);
+    pool.swap(otherTree.pool);
+}
+
+
 /**
  * duplicateTree ------------------------------------------------------------------------------------------------------------------------------
- * duplicateTree : recursively copies nodes from rhs to lhs, duplicating entire tree
+ * duplicateTree : iteratively copies nodes from rhs to lhs, duplicating entire tree. Each pending entry pairs
+ * the link to be filled in with the Node to copy into it, so no recursion is needed.
  *
  * @param lhs : Node to be replaced
  * @param rhs : Node to be copied
+ * @param pool : pool the copied Nodes are allocated from
  * Pre: none
  * Post: Deep copies rhs Node to lhs
  */
     
-void BinTree::duplicateTree(Node* &lhs, Node* rhs) {
-    if (rhs == NULL) {                          // base case
-        lhs = NULL;
-    } else {
-        lhs = new Node();                       // otherwise creates new node
-        lhs->left = NULL;
-        lhs->right = NULL;
-        lhs->data = new NodeData(*rhs->data);   // provides deep copy
-        
-        duplicateTree(lhs->left, rhs->left);    // accounts for all child nodes
-        duplicateTree(lhs->right, rhs->right);
+void BinTree::duplicateTree(Node* &lhs, Node* rhs, NodePool &pool) {
+    vector<pair<Node**, Node*> > pending;
+    pending.push_back(make_pair(&lhs, rhs));
+    while (!pending.empty()) {
+        Node** link = pending.back().first;
+        Node* source = pending.back().second;
+        pending.pop_back();
+        if (source == NULL) {                   // nothing to copy
+            *link = NULL;
+            continue;
+        }
+        Node* copy = pool.allocate();           // otherwise creates new node
+        copy->data = new NodeData(*source->data); // provides deep copy
+        copy->height = source->height;
+        copy->size = source->size;
+        *link = copy;
+        pending.push_back(make_pair(&copy->right, source->right));
+        pending.push_back(make_pair(&copy->left, source->left));
+    }
+}
+
+
+/**
+ * duplicateParallel --------------------------------------------------------------------------------------------------------------------------
+ * duplicateParallel : copies nodes from rhs to lhs, forking work across threads. While more than one thread is
+ * left and rhs is at least PARALLEL_THRESHOLD Nodes, the root is copied here, the right subtree is copied on a
+ * new thread into a pool of its own, and the left subtree is copied on this thread; the threads are split between
+ * the two halves. Otherwise the subtree is copied serially into a single reserved slab.
+ *
+ * @param lhs : Node to be replaced
+ * @param rhs : Node to be copied
+ * @param pool : pool the copied Nodes end up in
+ * @param threads : most threads to use, including this one
+ * Pre: none
+ * Post: Deep copies rhs Node to lhs, with exactly the shape, heights and sizes duplicateTree would produce
+ */
+
+void BinTree::duplicateParallel(Node* &lhs, Node* rhs, NodePool &pool, int threads) {
+    if (rhs == NULL || threads <= 1 || rhs->size < PARALLEL_THRESHOLD) {
+        pool.reserve(rhs == NULL ? 0 : rhs->size); // one slab for the subtree
+        duplicateTree(lhs, rhs, pool);
+        return;
+    }
+    Node* copy = pool.allocate();
+    copy->data = new NodeData(*rhs->data);
+    copy->height = rhs->height;
+    copy->size = rhs->size;
+    lhs = copy;
+    
+    NodePool rightPool;                         // outlives the worker below
+    int rightThreads = threads / 2;
+    future<void> rightDone = async(launch::async, [&]() {
+        duplicateParallel(copy->right, rhs->right, rightPool, rightThreads);
+    });
+    duplicateParallel(copy->left, rhs->left, pool, threads - rightThreads);
+    rightDone.get();                            // rethrows a worker failure
+    pool.absorb(rightPool);
+}
+
+
+/**
+ * defaultThreads -----------------------------------------------------------------------------------------------------------------------------
+ * defaultThreads : number of threads worth using on a tree of nodeCount Nodes
+ *
+ * @param nodeCount : number of Nodes to be copied or deallocated
+ * @return: 1 below PARALLEL_THRESHOLD, otherwise the hardware concurrency (at least 1)
+ */
+
+int BinTree::defaultThreads(int nodeCount) {
+    if (nodeCount < PARALLEL_THRESHOLD) {
+        return 1;
     }
+    return max(1, (int)thread::hardware_concurrency());
 }
 
     
@@ -165,7 +325,8 @@ bool BinTree::operator!=(const BinTree& rhsTree) const {
     
 /**
  * equalityHelper ----------------------------------------------------------------------------------------------------------------------------------
- * equalityHelper : recursively compares rhs nodes to lhs, throughout entire tree
+ * equalityHelper : iteratively compares rhs nodes to lhs, throughout entire tree. A subtree shared by both trees
+ * is equal to itself, so comparing a tree with a snapshot of it only walks the paths changed since.
  *
  * @param lhs : lhs Node to be compared
  * @param rhs : rhs Node to be compared
@@ -175,16 +336,23 @@ bool BinTree::operator!=(const BinTree& rhsTree) const {
  */
     
 bool BinTree::equalityHelper(Node* lhs, Node* rhs) const {
-    if (lhs == NULL && rhs == NULL) {           // same value
-        return true;
-    } else if (lhs == NULL || rhs == NULL) {    // differing values
-        return false;
-    } else if (*lhs->data == *rhs->data) {      // same values, check children
-        return (equalityHelper(lhs->left, rhs->left) &&
-                equalityHelper(lhs->right, rhs->right));
-    } else {                                    // differing values
-        return false;
+    vector<pair<Node*, Node*> > pending;
+    pending.push_back(make_pair(lhs, rhs));
+    while (!pending.empty()) {
+        lhs = pending.back().first;
+        rhs = pending.back().second;
+        pending.pop_back();
+        if (lhs == rhs) {                           // same subtree, or both NULL
+            continue;
+        } else if (lhs == NULL || rhs == NULL) {    // differing values
+            return false;
+        } else if (*lhs->data != *rhs->data) {      // differing values
+            return false;
+        }
+        pending.push_back(make_pair(lhs->right, rhs->right)); // check children
+        pending.push_back(make_pair(lhs->left, rhs->left));
     }
+    return true;
 }
 
 
@@ -208,10 +376,12 @@ bool BinTree::insert(NodeData* newData) {
     
 /**
  * insertHelper ----------------------------------------------------------------------------------------------------------------------------------
- * insertHelper : Helper function for insert. Recursively inserts a new Node containing the input newData
- * into the BinTree object
+ * insertHelper : Helper function for insert. Walks down from cur recording each link taken, deciding each step
+ * with a single three-way compare, links a new Node containing the input newData at the bottom, then fixes
+ * heights and balance back up the recorded path. Nodes shared with a snapshot are copied only once the insert is
+ * known to succeed.
  *
- * @param cur : parent Node to be compared to newData
+ * @param cur : root link of the subtree newData is inserted into
  * @param newData : the new newData object to be added to the tree
  * pre: newData object must be able to be comparable
  * post: inserts new Node struct containing newData, smaller to left, larger to the right, skips if already exists
@@ -219,296 +389,2145 @@ bool BinTree::insert(NodeData* newData) {
  */
     
 bool BinTree::insertHelper(Node* &cur, NodeData* newData) {
-    if (cur == NULL) {                              // base case to create new Node
-        cur = new Node();
-        cur->data = newData;
-        cur->left = NULL;
-        cur->right = NULL;
-        return true;
-    } else if (*newData < *cur->data) {             // BST, smaller goes left
-        return insertHelper(cur->left, newData);
-    } else if (*newData > *cur->data) {             // BST, larger goes right
-        return insertHelper(cur->right, newData);
-    } else {                                        // already exists, so skips
-        return false;
+    vector<Node**> path;                            // links from cur downward
+    Node** link = &cur;
+    while (*link != NULL) {
+        path.push_back(link);
+        int order = newData->compare(*(*link)->data); // one comparison per level
+        if (order < 0) {                            // BST, smaller goes left
+            link = &(*link)->left;
+        } else if (order > 0) {                     // BST, larger goes right
+            link = &(*link)->right;
+        } else {                                    // already exists, so skips
+            return false;
+        }
     }
+    unsharePath(path, link);                        // copy path shared with snapshots
+    *link = newNode();                              // create new Node
+    (*link)->data = newData;
+    fixPath(path);                                  // fix heights, sizes back up
+    return true;
 }
 
 
 /**
- * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
- * makeEmpty : deallocates all nodes of the BinTree object in this and sets root to NULL
- * pre: none
- * post: deallocates all nodes in memory and sets root to NULL
+ * remove -------------------------------------------------------------------
+ * remove : removes the Node whose data equals target from the BinTree object
+ *
+ * @param target : the NodeData value to be removed from the tree
+ * pre: target object must be able to be comparable
+ * post: the matching Node and its NodeData are deallocated; if this tree is balanced it stays AVL balanced
+ * @return: true if a Node was removed, false if target was not in the tree
  */
 
-void BinTree::makeEmpty() {
-    makeEmptyHelper(root);
+bool BinTree::remove(const NodeData &target) {
+    return removeHelper(root, target);
 }
-    
-    
+
+
 /**
- * makeEmptyHelper ----------------------------------------------------------------------------------------------------------------------------
- * makeEmptyHelper : helper function for makeEmpty. Deallocates all nodes of the BinTree object in this
- * and sets root to NULL
+ * removeHelper ----------------------------------------------------------------------------------------------------------------------------------
+ * removeHelper : Helper function for remove. Walks down from cur to the Node containing target, recording each
+ * link taken. A Node with two children takes the smallest NodeData of its right subtree in place of its own, and
+ * the Node that held it is spliced out instead. Heights and balance are then fixed back up the recorded path.
+ * Nodes shared with a snapshot are copied first, so the snapshot keeps the removed NodeData.
  *
- * @param cur : Node to be deleted
- * pre: none
- * post: deallocates all nodes in memory and sets root to NULL
+ * @param cur : root link of the subtree target is removed from
+ * @param target : the NodeData value to be removed from the tree
+ * pre: target object must be able to be comparable
+ * post: the matching NodeData and one Node are deallocated, heights along the path are updated
+ * @return: true if a Node was removed, false if target was not in the tree
  */
 
-void BinTree::makeEmptyHelper(Node*& cur) {
-    if (cur != NULL) {                      // can't deallocate if doesn't exist
-        makeEmptyHelper(cur->left);         // account for children
-        makeEmptyHelper(cur->right);
-        delete cur->data;                   // deallocates NodeData and Node
-        cur->data = NULL;
-        delete cur;
-        cur = NULL;
+bool BinTree::removeHelper(Node* &cur, const NodeData &target) {
+    vector<Node**> path;                            // links above the match
+    Node** link = &cur;
+    int order = 0;
+    while (*link != NULL && (order = target.compare(*(*link)->data)) != 0) {
+        path.push_back(link);
+        link = (order < 0) ? &(*link)->left : &(*link)->right;
+    }
+    if (*link == NULL) {                            // not in tree
+        return false;
+    }
+    size_t foundDepth = path.size();                // path index of the match
+    if ((*link)->left != NULL && (*link)->right != NULL) {
+        path.push_back(link);                       // find successor
+        link = &(*link)->right;
+        while ((*link)->left != NULL) {
+            path.push_back(link);
+            link = &(*link)->left;
+        }
+    }
+    unsharePath(path, link);                        // copy path shared with snapshots
+    Node* doomed = *link;
+    Node* found = (foundDepth < path.size()) ? *path[foundDepth] : doomed;
+    delete found->data;
+    if (found != doomed) {
+        found->data = doomed->data;                 // replace with successor
     }
+    *link = (doomed->left != NULL) ? doomed->left : doomed->right; // splice
+    doomed->data = NULL;
+    doomed->left = NULL;
+    doomed->right = NULL;
+    releaseTree(doomed);                            // linked from nowhere now
+    fixPath(path);                                  // fix heights, sizes back up
+    return true;
 }
 
 
-// Accessors ////////////////////////////////////////////////////////////////////
-    
 /**
- * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
- * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
- * to be NodeData object, if found
+ * fixPath ---------------------------------------------------------------------------------------------------------------------------------------
+ * fixPath : rebalances each link of a root-to-leaf path, deepest first. Every ancestor's subtree size changes, so
+ * the whole path is visited; its length is the same as the descent that produced it.
  *
- * @param dataDesired : pass-by-reference newData object to be searched for in tree
- * @param dataRetrieved : newData object to point to object in tree, if found
- * pre: newData object must be able to be comparable
- * post: if found, returns true and dataRetrieved points to object in tree
- * @return: the boolean value whether object is found
+ * @param path : links from the root of the change down to the parent of the modified Node
+ * pre: every subtree below the deepest link is already correct
+ * post: heights, sizes (and balance, if balanced) are correct along the whole path
  */
-    
-bool BinTree::retrieve(const NodeData &dataDesired, NodeData* &dataRetrieved) {
-    return retrieveHelper(this->root, dataDesired, dataRetrieved);
+
+void BinTree::fixPath(vector<Node**> &path) {
+    while (!path.empty()) {
+        rebalance(*path.back());
+        path.pop_back();
+    }
 }
-    
+
+
+// Split and Join ////////////////////////////////////////////////////////////////
 
 /**
- * retrieveHelper -------------------------------------------------------------------------------------------------------------------------------------
- * retrieveHelper : recursive helper function for retrieve function. Returns the
- * bool value of whether data desired is in this tree,modifying the dataRetrieved directly to be NodeData object, if found
+ * split -----------------------------------------------------------------------------------------------------------------------------------------
+ * split : splits this tree at key. The Nodes are not copied: both halves are made of this tree's Nodes and share its
+ * pool, so they are treated as sharing Nodes with each other from then on. On a balanced tree each half comes out
+ * balanced.
  *
- * @param dataDesired : pass-by-reference newData object to be searched for in tree
- * @param dataRetrieved : newData object to point to object in tree, if found
- * pre: newData object must be able to be comparable
- * post: if found, returns true and dataRetrieved points to object in tree
- * @return: the boolean value whether object is found
+ * @param key : value to split at; a NodeData equal to it goes to right
+ * @param left : tree to receive every NodeData less than key
+ * @param right : tree to receive every other NodeData
+ * pre: left and right are different trees
+ * post: this is empty unless it is left or right; what left and right held before is deallocated
  */
 
-bool BinTree::retrieveHelper(Node* &cur, const NodeData &dataDesired, NodeData* &dataRetrieved) const {
-    if (cur == NULL) {                          // Base case, NodeData not in tree
-        dataRetrieved = NULL;
-        return false;
-    } else if (dataDesired == *cur->data) {     // 2nd Base, NodeData found
-        dataRetrieved = cur->data;
-        return true;
-    } else if (dataDesired < *cur->data) {      // dataDesired smaller, check left
-        return retrieveHelper(cur->left, dataDesired, dataRetrieved);
-    } else {                                    // dataDesired larger, check right
-        return retrieveHelper(cur->right, dataDesired, dataRetrieved);
+void BinTree::split(const NodeData &key, BinTree &left, BinTree &right) {
+    Node* lower = NULL;
+    Node* upper = NULL;
+    splitHelper(root, key, lower, upper);
+    root = NULL;
+    shared_ptr<NodePool> nodes;
+    nodes.swap(pool);                               // this is now empty
+    left.makeEmpty();
+    right.makeEmpty();
+    left.root = lower;
+    right.root = upper;
+    if (lower != NULL) {
+        left.pool = nodes;
+    }
+    if (upper != NULL) {
+        right.pool = nodes;
     }
 }
 
 
 /**
- * getHeight ---------------------------------------------------------------------------------------------------------------------------------
- * getHeight : returns the height of a general tree of a given value.
- * The height of a leaf node is 1, and a value not found is zero.
+ * splitHelper -----------------------------------------------------------------------------------------------------------------------------------
+ * splitHelper : Helper function for split. Walks down from cur toward key, recording each link taken and making the
+ * Nodes on the way this tree's own. Then, from the bottom up, each Node on the path is joined, as the middle Node,
+ * with its subtree on the far side of key and the part of the split on that side collected so far. The heights
+ * joined grow along the way, so the joins cost O(height) in total.
  *
- * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param cur : root of the subtree to take apart
+ * @param key : value to split at
+ * @param lower : set to the root of the Nodes less than key
+ * @param upper : set to the root of the other Nodes
+ * @param match : if not NULL, set to the Node equal to key, with no children, which then goes in neither half; NULL
+ * if there is none
  * pre: none
- * post: if found, returns height of tree from node with found value.
- * @return: the height of the tree at the given node, 1 if leaf, 0 if not found
+ * post: every Node of cur is in exactly one of lower, upper and match, whose heights and sizes are correct
  */
 
-int BinTree::getHeight (const NodeData &dataDesired) const {
-    return getHeightHelper(root, dataDesired);
+void BinTree::splitHelper(Node* cur, const NodeData &key, Node* &lower, Node* &upper, Node** match) {
+    vector<Node**> path;                            // links above the match
+    Node** link = &cur;
+    int order = 0;
+    while (*link != NULL && (order = key.compare(*(*link)->data)) != 0) {
+        path.push_back(link);
+        link = (order < 0) ? &(*link)->left : &(*link)->right;
+    }
+    unsharePath(path, link);                        // the Nodes are reused
+    lower = NULL;
+    upper = NULL;
+    if (match != NULL) {
+        *match = *link;
+    }
+    if (*link != NULL) {                            // the match begins upper
+        Node* found = *link;
+        lower = found->left;
+        upper = found->right;
+        found->left = NULL;
+        found->right = NULL;
+        updateNode(found);
+        if (match == NULL) {
+            upper = joinHelper(NULL, found, upper);
+        }
+    }
+    for (size_t i = path.size(); i-- > 0; ) {
+        Node* middle = *path[i];
+        Node** below = (i + 1 < path.size()) ? path[i + 1] : link;
+        Node* smaller = middle->left;
+        Node* larger = middle->right;
+        middle->left = NULL;
+        middle->right = NULL;
+        if (below == &middle->left) {               // key is less than middle
+            upper = joinHelper(upper, middle, larger);
+        } else {
+            lower = joinHelper(smaller, middle, lower);
+        }
+    }
 }
 
 
 /**
- * getHeightHelper ---------------------------------------------------------------
- * getHeightHelper : recurisve helper function for getHeight. Returns the height of a general tree of a given value.
- * Height of a leaf node is 1, and a value not found is 0.
+ * join ------------------------------------------------------------------------------------------------------------------------------------------
+ * join : checks that left's largest NodeData is less than right's smallest, then joins the two trees. If their Nodes
+ * come from different pools, the pool of left adopts that of right, so this tree can link Nodes from both. If one
+ * pool already holds the other, that one is kept instead, and since the other may still be held elsewhere too, this
+ * tree treats its Nodes as shared from then on. Two balanced trees give a balanced tree.
  *
- * @param cur : current Node to be searched for dataDesired
- * @param dataDesired : pass-by-reference newData object to be searched for in tree
- * pre: none
- * post: if found, calls overloaded height function to find height at cur
- * @return the height of the tree at the given node, 1 if leaf, 0 if not found
+ * @param left : tree whose NodeData all come first
+ * @param right : tree whose NodeData all come last
+ * pre: left and right are different trees
+ * post: if true is returned, this holds every NodeData of both, and left and right are empty unless one is this;
+ * what this held before is deallocated
+ * @return: false, with nothing changed, if the two trees overlap
  */
-    
-int BinTree::getHeightHelper (Node* cur, const NodeData &dataDesired) const {
-    if (cur == NULL) {                          // Base case; doesn't exist is 0
-        return 0;
-    } else if (*cur->data == dataDesired) {     // calls overloaded getHeight
-        return getHeight(cur);
-    } else {                                    // Continues searching
-        return max(getHeightHelper(cur->left, dataDesired), // returns largest height
-                   getHeightHelper(cur->right, dataDesired));
+
+bool BinTree::join(BinTree &left, BinTree &right) {
+    if (left.root != NULL && right.root != NULL) {
+        Node* largest = left.root;
+        while (largest->right != NULL) {
+            largest = largest->right;
+        }
+        Node* smallest = right.root;
+        while (smallest->left != NULL) {
+            smallest = smallest->left;
+        }
+        if (!(*largest->data < *smallest->data)) {
+            return false;                           // ranges overlap
+        }
+    }
+    if (this != &left && this != &right) {
+        makeEmpty();
     }
+    Node* lower = left.root;
+    Node* upper = right.root;
+    shared_ptr<NodePool> lowerPool;
+    shared_ptr<NodePool> upperPool;
+    lowerPool.swap(left.pool);
+    upperPool.swap(right.pool);
+    left.root = NULL;
+    right.root = NULL;
+    pool = (lower != NULL) ? lowerPool : upperPool;
+    if (lower != NULL && upper != NULL && lowerPool != upperPool) {
+        if (upperPool->holds(lowerPool.get())) {    // never a pool holding itself
+            pool = upperPool;
+            pool->adoptedShared.store(true, memory_order_relaxed);
+        } else if (lowerPool->holds(upperPool.get())) {
+            pool->adoptedShared.store(true, memory_order_relaxed);
+        } else {
+            pool->adopt(upperPool);
+        }
+    }
+    lowerPool.reset();
+    upperPool.reset();
+    root = joinTrees(lower, upper);
+    return true;
 }
-    
+
 
 /**
- * getHeight -------------------------------------------------------------------
- * getHeight : overloaded getHeight recursively returns the height of a general tree of the given node.
- * The height of a leaf node is 1, and cur == NULL returns zero.
+ * joinHelper ------------------------------------------------------------------------------------------------------------------------------------
+ * joinHelper : joins left, middle and right. If the two subtrees are within one level of each other, middle simply
+ * becomes their parent. Otherwise middle is hung on the inner edge of the taller one, at the first Node there no more
+ * than one level taller than the shorter subtree, and the path down to it is rebalanced on the way back up. The work
+ * is proportional to the difference in height.
  *
- * @param cur : current Node of which to determine height
- * pre: none
- * post: returns height of tree from given node
- * @return: the height of the tree at the given node, 1 if leaf, 0 if NULL
+ * @param left : subtree whose NodeData are all less than middle's, may be NULL
+ * @param middle : Node with no children and a NodeData between the two subtrees
+ * @param right : subtree whose NodeData are all greater than middle's, may be NULL
+ * pre: middle is linked from nowhere else
+ * post: heights and sizes are correct; if this tree is balanced and left and right are AVL balanced, so is the result
+ * @return: root of the joined subtree
  */
 
-int BinTree::getHeight (Node* cur) const {
-    if (cur == NULL) {                       // Base case, doesn't exist is 0
-        return 0;
-    } else {                                 // Leaf nodes add 1, plus max height
-        return 1 + max(getHeight(cur->left), getHeight(cur->right));
+BinTree::Node* BinTree::joinHelper(Node* left, Node* middle, Node* right) {
+    Node* top = middle;
+    vector<Node**> path;                            // links down the taller side
+    Node** link = &top;
+    if (nodeHeight(left) > nodeHeight(right) + 1) {        // down left's right edge
+        top = left;
+        while (nodeHeight(*link) > nodeHeight(right) + 1) {
+            path.push_back(link);
+            link = &(*link)->right;
+        }
+        unsharePath(path, link);
+        middle->left = *link;
+        middle->right = right;
+    } else if (nodeHeight(right) > nodeHeight(left) + 1) { // down right's left edge
+        top = right;
+        while (nodeHeight(*link) > nodeHeight(left) + 1) {
+            path.push_back(link);
+            link = &(*link)->left;
+        }
+        unsharePath(path, link);
+        middle->left = left;
+        middle->right = *link;
+    } else {
+        middle->left = left;
+        middle->right = right;
     }
+    *link = middle;
+    updateNode(middle);
+    fixPath(path);                                  // fix heights, sizes back up
+    return top;
 }
 
 
-// Using Arrays ////////////////////////////////////////////////////////////////////
-
 /**
- *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
- *  bstreeToArray :  function to fill an array of NodeData using an inorder traversal of the tree. it leaves the tree empty,
- *  and the NodeData array passted in a statically-located array of 100 NULL elements.
+ * joinTrees -------------------------------------------------------------------------------------------------------------------------------------
+ * joinTrees : joins left and right without a middle Node of their own by detaching the smallest Node of right to
+ * serve as one
  *
- *  @param newArray : array to be filled with inorder traversal of NodeData elements from tree
- *  pre: NodeData array must be a statically-located array of 100 NULL elements
- *  post: tree will be deallocated and newArray filled with NodeData elements from tree in inorder traversal
+ * @param left : subtree whose NodeData all come first, may be NULL
+ * @param right : subtree whose NodeData all come last, may be NULL
+ * pre: every NodeData of left is less than every NodeData of right
+ * post: heights and sizes are correct, and balance is kept as in joinHelper
+ * @return: root of the joined subtree
  */
 
-void BinTree::bstreeToArray(NodeData* newArray[]) {
-    int index = 0;              // helper veriable to determine position in array
-    bstreeToArrayHelper(newArray, root, index);
-    makeEmpty();                // clear tree
+BinTree::Node* BinTree::joinTrees(Node* left, Node* right) {
+    if (right == NULL) {
+        return left;
+    }
+    if (left == NULL) {
+        return right;
+    }
+    Node* middle = detachMin(right);
+    return joinHelper(left, middle, right);
 }
 
 
 /**
-*  bstreeToArrayHelper  --------------------------------------------------------------------------------------------------------------------------------
-*  bstreeToArrayHelper : recursive helper function to bstToArray  to fill an array of NodeData using an inorder traversal of
-*  the tree. it leaves the tree empty,and the NodeData array passted in a statically-located array of 100 NULL elements.
-*
-* @param newArray : array to be filled with inorder traversal of NodeData elements from tree
-* @param cur : current Node to access NodeData
-* @param index : helper reference variable to keep track of position in array while being filled
-*  pre: NodeData array must be a statically-located array of 100 elements
-*  post: tree will be deallocated and newArray filled with NodeData elements from tree in inorder traversal
-*/
+ * detachMin -------------------------------------------------------------------------------------------------------------------------------------
+ * detachMin : walks down the left edge of cur to its smallest Node, making the Nodes on the way this tree's own, and
+ * replaces that Node with its right child
+ *
+ * @param cur : root link of a non-empty subtree
+ * pre: cur is not NULL
+ * post: cur no longer holds the returned Node, and its heights, sizes and balance are fixed
+ * @return: the smallest Node, with no children, height and size 1
+ */
 
-void BinTree::bstreeToArrayHelper(NodeData* newArray[], Node* cur, int& index) {
-    if (cur != NULL) {                              // Only copy actual Nodes
-        bstreeToArrayHelper(newArray, cur->left, index); // inorder traversal
-        newArray[index] = new NodeData(*cur->data); // Deep copy of NodeData
-        index++;                                    // Next position in array
-        bstreeToArrayHelper(newArray, cur->right, index); // continue traversal
+BinTree::Node* BinTree::detachMin(Node* &cur) {
+    vector<Node**> path;                            // links above the smallest
+    Node** link = &cur;
+    while ((*link)->left != NULL) {
+        path.push_back(link);
+        link = &(*link)->left;
     }
+    unsharePath(path, link);
+    Node* smallest = *link;
+    *link = smallest->right;
+    smallest->right = NULL;
+    updateNode(smallest);
+    fixPath(path);
+    return smallest;
 }
 
 
+// Set Operations ////////////////////////////////////////////////////////////////
+
 /**
-*  arraytoBSTree --------------------------------------------------------------------------------------------------------------------------------
-*  arraytoBSTree :  function to build a balanced BinTree from a sorted array of NodeData* elements, leaving the
-*  array filled with NULLS.
-*
-*  @param oldArray : 100-element NodeData array to be used to build BinTree. Elements taken will be replaced with NULL
-*  pre: NodeData array must be a statically-located array of size 100
-*  post: this will be emptied and replaced with a balanced BinTree made of elements from oldArray,
-*  which will be filled with NULLs
-*/
+ * unite -----------------------------------------------------------------------------------------------------------------------------------------
+ * unite : adds every NodeData of other to this tree, using up to as many threads as suit the two trees' sizes
+ *
+ * @param other : tree whose NodeData are added
+ * pre: none
+ * post: as for the overload taking a number of threads
+ */
 
-void BinTree::arrayToBSTree(NodeData* oldArray[]) {
-    int low = 0; int high = 0;          // creates bounds of array to be searched
-    for (int i = 0; i < 100; i++) {     // find highest index of NodeData in array
-        if (oldArray[i] != NULL) {
-            high++;
+void BinTree::unite(const BinTree &other) {
+    unite(other, defaultThreads(size() + other.size()));
+}
+
+
+/**
+ * unite -----------------------------------------------------------------------------------------------------------------------------------------
+ * unite : adds every NodeData of other to this tree. Subtrees of other with nothing of this tree in their range are
+ * linked into this tree as they are, not copied, so this tree's pool adopts other's pool and its Nodes are treated
+ * as shared from then on. If this tree is empty it simply becomes a copy of other, in O(1). If other's pool already
+ * holds this tree's pool, adopting it in turn would form a cycle, so this tree uses other's pool instead.
+ *
+ * @param other : tree whose NodeData are added; it is not changed
+ * @param threads : most threads to use, including the calling thread; 1 works serially
+ * pre: none
+ * post: this holds every NodeData of either tree, keeping its own NodeData where both hold an equal one; the result
+ * is balanced if both trees are
+ */
+
+void BinTree::unite(const BinTree &other, int threads) {
+    if (this == &other || other.root == NULL) {
+        return;
+    }
+    if (root == NULL) {                             // nothing of this tree to keep
+        makeEmpty();
+        pool = other.pool;
+        root = share(other.root);
+        return;
+    }
+    if (pool != other.pool) {
+        if (other.pool->holds(pool.get())) {        // it already keeps this pool alive
+            pool = other.pool;
+        } else {
+            pool->adopt(other.pool);
         }
+        pool->adoptedShared.store(true, memory_order_relaxed); // other links them too
     }
-    makeEmpty();
-    arrayToBSTreeHelper(oldArray, low, high - 1);
+    concurrent = threads > 1;                       // threads lock the pool meanwhile
+    root = uniteHelper(root, other.root, threads);
+    concurrent = false;
 }
 
 
 /**
-*  arraytoBSTreeHelper --------------------------------------------------------------------------------------------------------------------------------
-*  arraytoBSTreeHelper : recursive helpr function for arrayToBSTree, to  build a balanced BinTree from a sorted array of
-*  NodeData* elements, leaving the array filled with NULLS.
-*
-*  @param oldArray : 100-element NodeData array to be used to build BinTree. Elements taken will be replaced with NULL
-* @param low : lowest subscript of the array range
-* @param high : highest subscript of the array range
-*  pre: NodeData array must be a statically-located array of size 100
-*  post: elements from oldArray will be used to create a balanced BinTree, and afterward will be filled with NULLs
-*/
+ * intersect -------------------------------------------------------------------------------------------------------------------------------------
+ * intersect : removes from this tree every NodeData not in other, using up to as many threads as suit the two trees'
+ * sizes
+ *
+ * @param other : tree whose NodeData are kept
+ * pre: none
+ * post: as for the overload taking a number of threads
+ */
+
+void BinTree::intersect(const BinTree &other) {
+    intersect(other, defaultThreads(size() + other.size()));
+}
+
+
+/**
+ * intersect -------------------------------------------------------------------------------------------------------------------------------------
+ * intersect : removes from this tree every NodeData not in other. Only this tree's Nodes are kept, so nothing is
+ * shared with other.
+ *
+ * @param other : tree whose NodeData are kept; it is not changed
+ * @param threads : most threads to use, including the calling thread; 1 works serially
+ * pre: none
+ * post: this holds its own NodeData that other holds too, and the Nodes of the rest are deallocated; the result is
+ * balanced if both trees are
+ */
 
-void BinTree::arrayToBSTreeHelper(NodeData* oldArray[], int low, int high) {
-    if (high >= low) {
-        int midIndex = (low + high) / 2;
-        NodeData* newNode = oldArray[midIndex];
-        insert(newNode);
-        oldArray[midIndex] = NULL;
-        arrayToBSTreeHelper(oldArray, low, midIndex - 1);
-        arrayToBSTreeHelper(oldArray, midIndex + 1, high);
+void BinTree::intersect(const BinTree &other, int threads) {
+    if (this == &other || root == NULL) {
+        return;
     }
+    if (other.root == NULL) {
+        makeEmpty(threads);
+        return;
+    }
+    concurrent = threads > 1;                       // threads lock the pool meanwhile
+    root = intersectHelper(root, other.root, threads);
+    concurrent = false;
 }
 
 
 /**
- * displaySideways ------------------------------------------------------------------------------------------------------------------------
- * Displays a binary tree as though you are viewing it from the side; hard coded displaying to standard output.
- * Preconditions: NONE
- * Postconditions: BinTree remains unchanged.
+ * subtract --------------------------------------------------------------------------------------------------------------------------------------
+ * subtract : removes from this tree every NodeData in other, using up to as many threads as suit the two trees'
+ * sizes
+ *
+ * @param other : tree whose NodeData are removed
+ * pre: none
+ * post: as for the overload taking a number of threads
  */
 
-void BinTree::displaySideways() const {
-    sideways(root, 0);
+void BinTree::subtract(const BinTree &other) {
+    subtract(other, defaultThreads(size() + other.size()));
 }
 
+
 /**
- * Sideways ----------------------------------------------------------------------------------------------------------------------------
- * Helper method for displaySideways
- * Preconditions: NONE
- * Postconditions: BinTree remains unchanged.
- * @param current : current Node to be output
- * @param level : accounting for space at current depth level
+ * subtract --------------------------------------------------------------------------------------------------------------------------------------
+ * subtract : removes from this tree every NodeData in other
+ *
+ * @param other : tree whose NodeData are removed; it is not changed
+ * @param threads : most threads to use, including the calling thread; 1 works serially
+ * pre: none
+ * post: this holds its own NodeData that other does not, and the Nodes of the rest are deallocated; the result is
+ * balanced if this tree was
  */
 
-void BinTree::sideways(Node* current, int level) const {
-    if (current != NULL) {
-        level++;
-        sideways(current->right, level);
+void BinTree::subtract(const BinTree &other, int threads) {
+    if (root == NULL || other.root == NULL) {
+        return;
+    }
+    if (this == &other) {
+        makeEmpty(threads);
+        return;
+    }
+    concurrent = threads > 1;                       // threads lock the pool meanwhile
+    root = subtractHelper(root, other.root, threads);
+    concurrent = false;
+}
+
 
-        // indent for readability, 4 spaces per depth level
-        for (int i = level; i >= 0; i--) {
-            cout << "    ";
-        }
+/**
+ * uniteHelper -----------------------------------------------------------------------------------------------------------------------------------
+ * uniteHelper : Helper function for unite. Splits mine at the NodeData of theirs' root, unites each half with the
+ * subtree of theirs on the same side, and joins the two results around mine's equal Node, or a copy of theirs' root
+ * if mine has none. Each level of theirs splits pieces of mine that get smaller as they go, which gives the
+ * O(m log(n/m + 1)) bound for balanced trees of sizes m <= n.
+ *
+ * @param mine : subtree of this tree, taken apart
+ * @param theirs : subtree of the other tree, only read and shared
+ * @param threads : most threads to use, including this one
+ * pre: theirs' Nodes may be linked from this tree's pool
+ * post: mine's Nodes are all reused
+ * @return: root of the union
+ */
 
-        cout << *current->data << endl;        // display information of object
-        sideways(current->left, level);
+BinTree::Node* BinTree::uniteHelper(Node* mine, Node* theirs, int threads) {
+    if (theirs == NULL) {
+        return mine;
+    }
+    if (mine == NULL) {
+        return share(theirs);                       // linked, not copied
+    }
+    Node* lower;
+    Node* upper;
+    Node* found;
+    splitHelper(mine, *theirs->data, lower, upper, &found);
+    if (found == NULL) {
+        found = newNode();
+        found->data = new NodeData(*theirs->data);
     }
+    combineHalves(lower, upper, theirs, threads, &BinTree::uniteHelper);
+    return joinHelper(lower, found, upper);
 }
 
-// Helpers
 
 /**
- * isEmpty ----------------------------------------------------------------------------------------------------------------------------------
- * Function to determine if BinTree is empty or not, returning the bool value of emptiness
- * Pre: none
- * Post: returns true if BinTree is empty, meaning it contains no Node objects, false if not
+ * intersectHelper -------------------------------------------------------------------------------------------------------------------------------
+ * intersectHelper : Helper function for intersect. Splits mine at the NodeData of theirs' root, intersects each half
+ * with the subtree of theirs on the same side, and joins the two results, around mine's equal Node if it has one.
+ * Parts of mine with nothing of theirs in their range are deallocated.
+ *
+ * @param mine : subtree of this tree, taken apart
+ * @param theirs : subtree of the other tree, only read
+ * @param threads : most threads to use, including this one
+ * pre: none
+ * post: mine's Nodes are reused or deallocated
+ * @return: root of the intersection
  */
-bool BinTree::isEmpty() const {
-    if (root == NULL) {
-        return true;
+
+BinTree::Node* BinTree::intersectHelper(Node* mine, Node* theirs, int threads) {
+    if (mine == NULL) {
+        return NULL;
+    }
+    if (theirs == NULL) {
+        releaseTree(mine);
+        return NULL;
+    }
+    Node* lower;
+    Node* upper;
+    Node* found;
+    splitHelper(mine, *theirs->data, lower, upper, &found);
+    combineHalves(lower, upper, theirs, threads, &BinTree::intersectHelper);
+    if (found != NULL) {
+        return joinHelper(lower, found, upper);
+    }
+    return joinTrees(lower, upper);
+}
+
+
+/**
+ * subtractHelper --------------------------------------------------------------------------------------------------------------------------------
+ * subtractHelper : Helper function for subtract. Splits mine at the NodeData of theirs' root, deallocating mine's
+ * equal Node if it has one, subtracts from each half the subtree of theirs on the same side, and joins the results.
+ *
+ * @param mine : subtree of this tree, taken apart
+ * @param theirs : subtree of the other tree, only read
+ * @param threads : most threads to use, including this one
+ * pre: none
+ * post: mine's Nodes are reused or deallocated
+ * @return: root of the difference
+ */
+
+BinTree::Node* BinTree::subtractHelper(Node* mine, Node* theirs, int threads) {
+    if (mine == NULL || theirs == NULL) {
+        return mine;
+    }
+    Node* lower;
+    Node* upper;
+    Node* found;
+    splitHelper(mine, *theirs->data, lower, upper, &found);
+    releaseTree(found);
+    combineHalves(lower, upper, theirs, threads, &BinTree::subtractHelper);
+    return joinTrees(lower, upper);
+}
+
+
+/**
+ * combineHalves ---------------------------------------------------------------------------------------------------------------------------------
+ * combineHalves : applies a set operation helper to lower with theirs' left subtree and to upper with theirs' right
+ * subtree. While more than one thread is left and the Nodes involved number at least PARALLEL_THRESHOLD, the upper
+ * half runs on a new thread and the lower half on this one, with the threads split between them as
+ * duplicateParallel splits them.
+ *
+ * @param lower : the part of this tree below theirs' root, replaced with the result
+ * @param upper : the part of this tree above theirs' root, replaced with the result
+ * @param theirs : subtree of the other tree
+ * @param threads : most threads to use, including this one
+ * @param combine : uniteHelper, intersectHelper or subtractHelper
+ * pre: while more than one thread is used, concurrent is true, so the pool is locked
+ * post: lower and upper are the two results
+ */
+
+void BinTree::combineHalves(Node* &lower, Node* &upper, Node* theirs, int threads,
+                            Node* (BinTree::*combine)(Node*, Node*, int)) {
+    if (threads <= 1 || nodeSize(lower) + nodeSize(upper) + nodeSize(theirs) < PARALLEL_THRESHOLD) {
+        lower = (this->*combine)(lower, theirs->left, 1);
+        upper = (this->*combine)(upper, theirs->right, 1);
+        return;
+    }
+    int upperThreads = threads / 2;
+    future<Node*> upperDone = async(launch::async, [&]() {
+        return (this->*combine)(upper, theirs->right, upperThreads);
+    });
+    lower = (this->*combine)(lower, theirs->left, threads - upperThreads);
+    upper = upperDone.get();                        // rethrows a worker failure
+}
+
+
+// Sharing //////////////////////////////////////////////////////////////////////
+
+/**
+ * unsharePath -----------------------------------------------------------------------------------------------------------------------------------
+ * unsharePath : path copying. Walks a root-to-leaf path top down and replaces each Node another tree also links
+ * to with a private copy. A copy shares its children, so every shared Node below it on the path is copied in
+ * turn, while the subtrees hanging off the path stay shared.
+ *
+ * @param path : links from the root of the change down to the parent of the final link
+ * @param link : final link of the path
+ * pre: each link on the path is a child link of the Node at the link before it
+ * post: every Node on the path and the Node at link belong to this tree alone, and path and link refer to the
+ * links of those Nodes
+ */
+
+void BinTree::unsharePath(vector<Node**> &path, Node** &link) {
+    if (!isShared()) {                              // no other tree to share with
+        return;
+    }
+    for (size_t i = 0; i < path.size(); i++) {
+        Node* old = *path[i];
+        if (makeUnique(*path[i])) {                 // follow the copy down
+            Node** &next = (i + 1 < path.size()) ? path[i + 1] : link;
+            next = (next == &old->left) ? &(*path[i])->left : &(*path[i])->right;
+        }
+    }
+    makeUnique(*link);
+}
+
+
+/**
+ * makeUnique ------------------------------------------------------------------------------------------------------------------------------------
+ * makeUnique : copies the Node at cur, with its NodeData, if any other link refers to it. The copy takes over this
+ * link's reference, and its children gain one reference each.
+ *
+ * @param cur : link to a Node this tree is about to modify
+ * pre: none
+ * post: the Node at cur, if any, is linked only from cur
+ * @return: true if a copy was made
+ */
+
+bool BinTree::makeUnique(Node* &cur) {
+    if (cur == NULL || cur->refs.load(memory_order_acquire) == 1) {
+        return false;
+    }
+    Node* copy = newNode();
+    copy->data = new NodeData(*cur->data);
+    copy->left = share(cur->left);
+    copy->right = share(cur->right);
+    copy->height = cur->height;
+    copy->size = cur->size;
+    releaseTree(cur);                               // drop this link's reference
+    cur = copy;
+    return true;
+}
+
+
+/**
+ * share -----------------------------------------------------------------------------------------------------------------------------------------
+ * share : counts one more link to cur
+ *
+ * @param cur : Node gaining a link, may be NULL
+ * @return: cur
+ */
+
+BinTree::Node* BinTree::share(Node* cur) {
+    if (cur != NULL) {
+        cur->refs.fetch_add(1, memory_order_relaxed);
+    }
+    return cur;
+}
+
+
+/**
+ * releaseTree -----------------------------------------------------------------------------------------------------------------------------------
+ * releaseTree : drops one link to cur. A Node left with no links has its NodeData deleted, drops its own links to
+ * its children, and goes back to the pool; while the pool is shared, the Nodes freed are returned under a single
+ * hold of its lock.
+ *
+ * @param cur : root of the subtree losing a link, may be NULL
+ * pre: none
+ * post: Nodes still linked from another tree are untouched
+ */
+
+void BinTree::releaseTree(Node* cur) {
+    vector<Node*> pending(1, cur);
+    vector<Node*> freed;
+    while (!pending.empty()) {
+        cur = pending.back();
+        pending.pop_back();
+        if (cur == NULL || cur->refs.fetch_sub(1, memory_order_acq_rel) != 1) {
+            continue;                               // still linked elsewhere
+        }
+        delete cur->data;
+        pending.push_back(cur->left);
+        pending.push_back(cur->right);
+        freed.push_back(cur);
+    }
+    unique_lock<mutex> guard(pool->lock, defer_lock);
+    if (!freed.empty() && lockNeeded()) {
+        guard.lock();
+    }
+    for (size_t i = 0; i < freed.size(); i++) {
+        pool->release(freed[i]);
+    }
+}
+
+
+/**
+ * isShared --------------------------------------------------------------------------------------------------------------------------------------
+ * isShared : true if another tree holds this tree's pool, or some pool it has adopted is still held elsewhere, and
+ * so may share its Nodes. Trees only share Nodes through a shared pool, so when this is false every Node is linked
+ * only from this tree. The adopted pools are only looked at while adoptedShared is set, and it is cleared the first
+ * time none of them is held elsewhere, so a tree is back to unshared speed once the trees it took Nodes from are
+ * gone.
+ */
+
+bool BinTree::isShared() const {
+    if (!pool) {
+        return false;
+    }
+    if (pool.use_count() > 1) {
+        return true;
+    }
+    return pool->adoptedShared.load(memory_order_relaxed) && pool->heldElsewhere();
+}
+
+
+/**
+ * lockNeeded ------------------------------------------------------------------------------------------------------------------------------------
+ * lockNeeded : true if allocating or releasing a Node must hold the pool's lock: while other trees may use the pool,
+ * or while a set operation of this tree runs on several threads
+ */
+
+bool BinTree::lockNeeded() const {
+    return concurrent || isShared();
+}
+
+
+/**
+ * newNode ---------------------------------------------------------------------------------------------------------------------------------------
+ * newNode : allocates a Node from this tree's pool, creating the pool on first use and locking it while shared
+ *
+ * @return: a Node with NULL data and children, height, size and refs 1
+ */
+
+BinTree::Node* BinTree::newNode() {
+    if (!pool) {
+        pool = make_shared<NodePool>();
+    }
+    unique_lock<mutex> guard(pool->lock, defer_lock);
+    if (lockNeeded()) {
+        guard.lock();
+    }
+    return pool->allocate();
+}
+
+
+// Balancing /////////////////////////////////////////////////////////////////////
+
+/**
+ * nodeHeight ---------------------------------------------------------------
+ * nodeHeight : returns the cached height of cur, 0 if NULL
+ */
+
+int BinTree::nodeHeight(Node* cur) const {
+    return (cur == NULL) ? 0 : cur->height;
+}
+
+
+/**
+ * nodeSize -----------------------------------------------------------------
+ * nodeSize : returns the cached number of Nodes in the subtree at cur, 0 if NULL
+ */
+
+int BinTree::nodeSize(Node* cur) const {
+    return (cur == NULL) ? 0 : cur->size;
+}
+
+
+/**
+ * updateNode ---------------------------------------------------------------
+ * updateNode : recomputes the cached height and size of cur from its children
+ * pre: cur is not NULL and its children's heights and sizes are correct
+ */
+
+void BinTree::updateNode(Node* cur) {
+    cur->height = 1 + max(nodeHeight(cur->left), nodeHeight(cur->right));
+    cur->size = 1 + nodeSize(cur->left) + nodeSize(cur->right);
+}
+
+
+/**
+ * rotateLeft ---------------------------------------------------------------
+ * rotateLeft : rotates the subtree rooted at cur to the left, so its right child becomes the new root. Either
+ * Node is copied first if a snapshot shares it.
+ * pre: cur and cur->right are not NULL
+ * post: cur refers to the new subtree root, and heights and sizes of both moved Nodes are updated
+ */
+
+void BinTree::rotateLeft(Node* &cur) {
+    makeUnique(cur);
+    makeUnique(cur->right);
+    Node* pivot = cur->right;
+    cur->right = pivot->left;
+    pivot->left = cur;
+    updateNode(cur);
+    updateNode(pivot);
+    cur = pivot;
+}
+
+
+/**
+ * rotateRight --------------------------------------------------------------
+ * rotateRight : rotates the subtree rooted at cur to the right, so its left child becomes the new root. Either
+ * Node is copied first if a snapshot shares it.
+ * pre: cur and cur->left are not NULL
+ * post: cur refers to the new subtree root, and heights and sizes of both moved Nodes are updated
+ */
+
+void BinTree::rotateRight(Node* &cur) {
+    makeUnique(cur);
+    makeUnique(cur->left);
+    Node* pivot = cur->left;
+    cur->left = pivot->right;
+    pivot->right = cur;
+    updateNode(cur);
+    updateNode(pivot);
+    cur = pivot;
+}
+
+
+/**
+ * rebalance ----------------------------------------------------------------
+ * rebalance : updates the height and size of cur and, if this tree is balanced, performs the single or double rotation
+ * that restores the AVL property at cur
+ *
+ * @param cur : root of a subtree whose children are already AVL balanced
+ * pre: cur is not NULL
+ * post: cur has a correct height and size; if balanced, its children differ in height by at most one
+ */
+
+void BinTree::rebalance(Node* &cur) {
+    if (cur == NULL) {
+        return;
+    }
+    updateNode(cur);
+    if (!balanced) {                                // plain BST, heights only
+        return;
+    }
+    int balance = nodeHeight(cur->left) - nodeHeight(cur->right);
+    if (balance > 1) {                              // left heavy
+        if (nodeHeight(cur->left->left) < nodeHeight(cur->left->right)) {
+            rotateLeft(cur->left);                  // left-right case
+        }
+        rotateRight(cur);
+    } else if (balance < -1) {                      // right heavy
+        if (nodeHeight(cur->right->right) < nodeHeight(cur->right->left)) {
+            rotateRight(cur->right);                // right-left case
+        }
+        rotateLeft(cur);
+    }
+}
+
+
+/**
+ * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
+ * makeEmpty : deallocates all nodes of the BinTree object in this and sets root to NULL
+ * pre: none
+ * post: deallocates all NodeData and Node slabs in memory and sets root to NULL
+ */
+
+void BinTree::makeEmpty() {
+    makeEmpty(defaultThreads(size()));
+}
+
+
+/**
+ * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
+ * makeEmpty : overloaded makeEmpty deallocates all nodes of the BinTree object using up to threads threads. If
+ * copies of this tree still share its pool, only the Nodes no copy links to are deallocated, one at a time.
+ *
+ * @param threads : most threads to use, including the calling thread; 1 deallocates serially
+ * pre: none
+ * post: deallocates all NodeData and Node slabs in memory and sets root to NULL
+ */
+
+void BinTree::makeEmpty(int threads) {
+    if (isShared()) {           // walk only what no other tree links to
+        releaseTree(root);
+        pool.reset();
+    } else if (pool) {
+        pool->clear(threads);   // releases every Node without walking the tree
+    }
+    root = NULL;
+}
+
+
+// Node Pool ////////////////////////////////////////////////////////////////////
+
+/**
+ * NodePool ---------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates a pool with no slabs and an empty free list
+ */
+
+BinTree::NodePool::NodePool() {
+    slabs = NULL;
+    freeList = NULL;
+    adoptedShared.store(false, memory_order_relaxed);
+}
+
+
+/**
+ * ~NodePool --------------------------------------------------------------------------------------------------------------------------
+ * Destructor : deallocates every slab along with the NodeData still held by its Nodes
+ */
+
+BinTree::NodePool::~NodePool() {
+    clear();
+}
+
+
+/**
+ * allocate ---------------------------------------------------------------------------------------------------------------------------
+ * allocate : hands out a Node, preferring the free list, then the current slab, then a new slab twice the size
+ * of the last one (capped at MAX_SLAB)
+ *
+ * pre: none
+ * post: returned Node has NULL data and children, and height, size and refs 1
+ * @return: pointer to a Node owned by this pool
+ */
+
+BinTree::Node* BinTree::NodePool::allocate() {
+    Node* fresh;
+    if (freeList != NULL) {                     // reuse a released Node first
+        fresh = freeList;
+        freeList = freeList->left;
+    } else {
+        if (slabs == NULL || slabs->used == slabs->capacity) {
+            Slab* slab = new Slab();            // current slab full, grow
+            slab->capacity = (slabs == NULL) ? MIN_SLAB
+                : min(slabs->capacity * 2, (int)MAX_SLAB);
+            slab->nodes = new Node[slab->capacity];
+            slab->used = 0;
+            slab->next = slabs;
+            slabs = slab;
+        }
+        fresh = &slabs->nodes[slabs->used++];
+    }
+    fresh->data = NULL;
+    fresh->left = NULL;
+    fresh->right = NULL;
+    fresh->height = 1;
+    fresh->size = 1;
+    fresh->refs.store(1, memory_order_relaxed);
+    return fresh;
+}
+
+
+/**
+ * release ----------------------------------------------------------------------------------------------------------------------------
+ * release : returns one Node to the free list so a later allocate can reuse it
+ *
+ * @param cur : Node previously handed out by this pool
+ * pre: cur's NodeData has already been deallocated or handed elsewhere
+ * post: cur is on the free list with NULL data
+ */
+
+void BinTree::NodePool::release(Node* cur) {
+    cur->data = NULL;                           // clear() skips free Nodes
+    cur->right = NULL;
+    cur->left = freeList;
+    freeList = cur;
+}
+
+
+/**
+ * reserve ----------------------------------------------------------------------------------------------------------------------------
+ * reserve : makes sure the next count allocations are served from a single slab, starting a new slab of exactly
+ * that size if the current one does not have room. Used when the number of Nodes needed is known up front.
+ *
+ * @param count : number of Nodes about to be allocated
+ * pre: none
+ * post: the current slab has room for at least count more Nodes
+ */
+
+void BinTree::NodePool::reserve(int count) {
+    if (count <= 0 || (slabs != NULL && slabs->capacity - slabs->used >= count)) {
+        return;
+    }
+    Slab* slab = new Slab();
+    slab->capacity = max(count, (int)MIN_SLAB);
+    slab->nodes = new Node[slab->capacity];
+    slab->used = 0;
+    slab->next = slabs;
+    slabs = slab;
+}
+
+
+/**
+ * discard ----------------------------------------------------------------------------------------------------------------------------
+ * discard : deallocates every slab without deleting the NodeData held by its Nodes, and does the same for each
+ * adopted pool no other tree holds
+ *
+ * pre: every NodeData still referenced by a live Node is owned by someone else
+ * post: pool holds no slabs, no adopted pools and an empty free list
+ */
+
+void BinTree::NodePool::discard() {
+    while (slabs != NULL) {
+        Slab* doomed = slabs;
+        slabs = doomed->next;
+        delete [] doomed->nodes;
+        delete doomed;
+    }
+    freeList = NULL;
+    for (size_t i = 0; i < adopted.size(); i++) {
+        if (adopted[i].use_count() == 1) {
+            adopted[i]->discard();
+        }
+    }
+    adopted.clear();
+}
+
+
+/**
+ * clear ------------------------------------------------------------------------------------------------------------------------------
+ * clear : deletes the NodeData of every live Node by scanning the slabs in order, then deallocates the slabs.
+ * With more than one thread, the slabs are dealt out to the threads in runs of roughly equal Node counts.
+ *
+ * @param threads : most threads to use, including the calling thread
+ * pre: none
+ * post: pool holds no slabs and an empty free list
+ */
+
+void BinTree::NodePool::clear(int threads) {
+    vector<Slab*> all;
+    int total = 0;
+    for (Slab* slab = slabs; slab != NULL; slab = slab->next) {
+        all.push_back(slab);
+        total += slab->used;
+    }
+    auto deleteData = [&all](size_t first, size_t last) {
+        for (size_t s = first; s < last; s++) {
+            for (int i = 0; i < all[s]->used; i++) {
+                delete all[s]->nodes[i].data;   // NULL for released Nodes
+            }
+        }
+    };
+    
+    vector<future<void> > workers;
+    size_t first = 0;
+    int share = total / max(threads, 1) + 1;    // Nodes per thread
+    while (threads > 1 && first < all.size()) {
+        size_t last = first;
+        int taken = 0;
+        while (last < all.size() && taken < share) {
+            taken += all[last++]->used;
+        }
+        if (last == all.size()) {               // final run stays here
+            break;
+        }
+        workers.push_back(async(launch::async, deleteData, first, last));
+        first = last;
+        threads--;
+    }
+    deleteData(first, all.size());
+    for (size_t w = 0; w < workers.size(); w++) {
+        workers[w].get();
+    }
+    vector<shared_ptr<NodePool> > kept;
+    kept.swap(adopted);                         // each clears itself when
+    kept.clear();                               // no other tree holds it
+    discard();
+}
+
+
+/**
+ * absorb -----------------------------------------------------------------------------------------------------------------------------
+ * absorb : takes over every slab and free Node of otherPool. Its slabs go in front of this pool's, so allocation
+ * continues in whatever room is left in otherPool's newest slab.
+ *
+ * @param otherPool : pool whose Nodes now belong to this pool
+ * pre: none
+ * post: this pool owns every Node either pool owned, and otherPool is empty
+ */
+
+void BinTree::NodePool::absorb(NodePool &otherPool) {
+    if (otherPool.slabs != NULL) {
+        Slab* tail = otherPool.slabs;
+        while (tail->next != NULL) {
+            tail = tail->next;
+        }
+        tail->next = slabs;
+        slabs = otherPool.slabs;
+        otherPool.slabs = NULL;
+    }
+    while (otherPool.freeList != NULL) {        // move released Nodes over
+        Node* cur = otherPool.freeList;
+        otherPool.freeList = cur->left;
+        cur->left = freeList;
+        freeList = cur;
+    }
+    adopted.insert(adopted.end(), otherPool.adopted.begin(), otherPool.adopted.end());
+    otherPool.adopted.clear();
+    if (otherPool.adoptedShared.load(memory_order_relaxed)) {
+        adoptedShared.store(true, memory_order_relaxed);
+    }
+}
+
+
+/**
+ * adopt ------------------------------------------------------------------------------------------------------------------------------
+ * adopt : holds on to otherPool for as long as this pool lives, so a tree using this pool may link Nodes carved from
+ * otherPool's slabs; when such a Node is freed it joins this pool's free list. If anything else still holds
+ * otherPool, those Nodes may be shared with it, so adoptedShared is set and the trees using this pool treat their
+ * Nodes as shared until heldElsewhere finds otherPool held by this pool alone.
+ *
+ * @param otherPool : pool to keep alive, may be NULL
+ * pre: otherPool does not hold this pool, so no pool ends up holding itself
+ * post: otherPool lives at least as long as this pool
+ */
+
+void BinTree::NodePool::adopt(const shared_ptr<NodePool> &otherPool) {
+    if (!otherPool) {
+        return;
+    }
+    if (otherPool.use_count() > 1                // held by more than the caller
+        || otherPool->adoptedShared.load(memory_order_relaxed)) {
+        adoptedShared.store(true, memory_order_relaxed);
+    }
+    lock_guard<mutex> guard(lock);
+    adopted.push_back(otherPool);
+}
+
+
+/**
+ * heldElsewhere ----------------------------------------------------------------------------------------------------------------------
+ * heldElsewhere : walks the pools this one has adopted, and those they have adopted in turn, looking for one held by
+ * anything besides the pool that adopted it. Nothing else can reach those pools while only one tree holds this
+ * pool, so the lists are read without locking. Finding none, it clears adoptedShared, and the acquire fence orders
+ * everything the other holders did before letting go ahead of this tree changing their former Nodes in place.
+ *
+ * pre: exactly one tree holds this pool
+ * post: adoptedShared is false if the result is
+ * @return: true if a Node of an adopted pool may still be linked from another tree
+ */
+
+bool BinTree::NodePool::heldElsewhere() {
+    vector<NodePool*> pending(1, this);
+    while (!pending.empty()) {
+        NodePool* cur = pending.back();
+        pending.pop_back();
+        for (size_t i = 0; i < cur->adopted.size(); i++) {
+            if (cur->adopted[i].use_count() > 1) {
+                return true;                        // another holder remains
+            }
+            pending.push_back(cur->adopted[i].get());
+        }
+    }
+    atomic_thread_fence(memory_order_acquire);      // after the last holder let go
+    adoptedShared.store(false, memory_order_relaxed);
+    return false;
+}
+
+
+/**
+ * holds ------------------------------------------------------------------------------------------------------------------------------
+ * holds : searches the pools this one has adopted, and the pools they have adopted in turn, for otherPool
+ *
+ * @param otherPool : pool to look for
+ * pre: none
+ * post: no pool is changed
+ * @return: true if otherPool lives at least as long as this pool because of an adoption
+ */
+
+bool BinTree::NodePool::holds(const NodePool* otherPool) {
+    vector<shared_ptr<NodePool> > kept;
+    {
+        lock_guard<mutex> guard(lock);
+        kept = adopted;
+    }
+    for (size_t i = 0; i < kept.size(); i++) {
+        if (kept[i].get() == otherPool || kept[i]->holds(otherPool)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+    
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
+ * to be NodeData object, if found. If the tree shares Nodes with a copy, the path down to it is copied first, as a
+ * change would copy it, so writing through dataRetrieved affects this tree alone.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree, which no copy of the tree shares
+ * @return: the boolean value whether object is found
+ */
+    
+bool BinTree::retrieve(const NodeData &dataDesired, NodeData* &dataRetrieved) {
+    vector<Node**> path;                            // links above the match
+    Node** link = &root;
+    int order = 0;
+    while (*link != NULL && (order = dataDesired.compare(*(*link)->data)) != 0) {
+        path.push_back(link);
+        link = (order < 0) ? &(*link)->left : &(*link)->right;
+    }
+    if (*link == NULL) {
+        dataRetrieved = NULL;                       // NodeData not in tree
+        return false;
+    }
+    unsharePath(path, link);                        // copies see no change made
+    dataRetrieved = (*link)->data;
+    return true;
+}
+
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded retrieve : as retrieve, but hands out the NodeData read-only, so it can be shared with copies and
+ * nothing is copied
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: tree is unchanged; if found, returns true and dataRetrieved points to object in tree
+ * @return: the boolean value whether object is found
+ */
+
+bool BinTree::retrieve(const NodeData &dataDesired, const NodeData* &dataRetrieved) const {
+    Node* top = root;
+    return retrieveHelper(top, dataDesired, dataRetrieved);
+}
+    
+
+/**
+ * retrieveHelper -------------------------------------------------------------------------------------------------------------------------------------
+ * retrieveHelper : iterative helper function for retrieve function. Returns the
+ * bool value of whether data desired is in this tree,modifying the dataRetrieved directly to be NodeData object, if found
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree
+ * @return: the boolean value whether object is found
+ */
+
+bool BinTree::retrieveHelper(Node* &cur, const NodeData &dataDesired, const NodeData* &dataRetrieved) const {
+    Node* walk = cur;
+    while (walk != NULL) {
+        int order = dataDesired.compare(*walk->data);
+        if (order == 0) {                           // NodeData found
+            dataRetrieved = walk->data;
+            return true;
+        } else if (order < 0) {                     // dataDesired smaller, check left
+            walk = walk->left;
+        } else {                                    // dataDesired larger, check right
+            walk = walk->right;
+        }
+    }
+    dataRetrieved = NULL;                           // NodeData not in tree
+    return false;
+}
+
+
+/**
+ * retrieveBatch -----------------------------------------------------------------------------------------------------------------------------
+ * retrieveBatch : looks up many values with their descents interleaved. Each of up to BATCH_LANES lanes follows
+ * one probe down the tree, alternating two steps: request the NodeData of its current Node, then compare against
+ * it and request the child it moves to. Every other lane takes its turn before a lane comes back to the memory
+ * it requested, so a lane rarely waits on a miss. A lane whose probe is found, or falls off the tree, starts on
+ * the next probe. A tree under BATCH_THRESHOLD Nodes is small enough to stay cached, so there the probes are just
+ * looked up one after another.
+ *
+ * @param probes : values to look for
+ * @param count : number of probes
+ * @param found : set to the NodeData in the tree equal to each probe, or NULL; room for count entries
+ * pre: probes must be able to be comparable
+ * post: tree is unchanged; found[i] is what retrieve(probes[i], found[i]) would set
+ * @return: the number of probes found
+ */
+
+int BinTree::retrieveBatch(const NodeData probes[], int count, const NodeData* found[]) const {
+    struct Lane {
+        int probe;                              // index of the probe followed
+        Node* cur;                              // Node reached so far
+        bool dataRequested;                     // cur->data already prefetched
+    };
+    int hits = 0;
+    if (size() < BATCH_THRESHOLD) {
+        Node* top = root;
+        for (int i = 0; i < count; i++) {
+            hits += retrieveHelper(top, probes[i], found[i]);
+        }
+        return hits;
+    }
+    Lane lanes[BATCH_LANES];
+    int active = 0;
+    int next = 0;                               // next probe to start
+    while (active < BATCH_LANES && next < count) {
+        lanes[active].probe = next++;
+        lanes[active].cur = root;
+        lanes[active].dataRequested = false;
+        active++;
+    }
+    while (active > 0) {
+        for (int i = 0; i < active; ) {
+            Lane &lane = lanes[i];
+            if (lane.cur != NULL && !lane.dataRequested) {
+                __builtin_prefetch(lane.cur->data);
+                lane.dataRequested = true;
+                i++;
+                continue;
+            }
+            int order = (lane.cur == NULL) ? 0 : probes[lane.probe].compare(*lane.cur->data);
+            if (order != 0) {                   // step down, request the child
+                lane.cur = (order < 0) ? lane.cur->left : lane.cur->right;
+                __builtin_prefetch(lane.cur);
+                lane.dataRequested = false;
+                i++;
+                continue;
+            }
+            found[lane.probe] = (lane.cur == NULL) ? NULL : lane.cur->data;
+            hits += (lane.cur != NULL);
+            if (next < count) {                 // reuse the lane
+                lane.probe = next++;
+                lane.cur = root;
+                lane.dataRequested = false;
+            } else {                            // retire the lane
+                lane = lanes[--active];
+            }
+        }
+    }
+    return hits;
+}
+
+
+/**
+ * getHeight ---------------------------------------------------------------------------------------------------------------------------------
+ * getHeight : returns the height of a general tree of a given value.
+ * The height of a leaf node is 1, and a value not found is zero.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * pre: none
+ * post: if found, returns height of tree from node with found value.
+ * @return: the height of the tree at the given node, 1 if leaf, 0 if not found
+ */
+
+int BinTree::getHeight (const NodeData &dataDesired) const {
+    return getHeightHelper(root, dataDesired);
+}
+
+
+/**
+ * getHeightHelper ---------------------------------------------------------------
+ * getHeightHelper : helper function for getHeight. Descends by the BST ordering to the Node holding dataDesired
+ * and returns its cached height, so the cost is one root-to-node walk. Height of a leaf node is 1, and a value
+ * not found is 0.
+ *
+ * @param cur : current Node to be searched for dataDesired
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * pre: none
+ * post: if found, returns the height cached at the Node holding dataDesired
+ * @return the height of the tree at the given node, 1 if leaf, 0 if not found
+ */
+    
+int BinTree::getHeightHelper (Node* cur, const NodeData &dataDesired) const {
+    while (cur != NULL) {
+        int order = dataDesired.compare(*cur->data);
+        if (order == 0) {                       // found, height is cached
+            return getHeight(cur);
+        }
+        cur = (order < 0) ? cur->left : cur->right;
+    }
+    return 0;                                   // doesn't exist is 0
+}
+    
+
+/**
+ * getHeight -------------------------------------------------------------------
+ * getHeight : overloaded getHeight returns the height of a general tree of the given node, which every Node
+ * caches and keeps up to date on insert and remove. The height of a leaf node is 1, and cur == NULL returns zero.
+ *
+ * @param cur : current Node of which to determine height
+ * pre: none
+ * post: returns height of tree from given node
+ * @return: the height of the tree at the given node, 1 if leaf, 0 if NULL
+ */
+
+int BinTree::getHeight (Node* cur) const {
+    return nodeHeight(cur);
+}
+
+
+/**
+ * height ----------------------------------------------------------------------
+ * height : returns the height of the whole tree, read from the root's cached height
+ *
+ * pre: none
+ * post: tree is unchanged
+ * @return: the height of the tree, 1 if only a root, 0 if empty
+ */
+
+int BinTree::height() const {
+    return nodeHeight(root);
+}
+
+
+/**
+ * size ------------------------------------------------------------------------
+ * size : returns the number of NodeData objects in the tree, read from the root's cached size
+ *
+ * pre: none
+ * post: tree is unchanged
+ * @return: the number of Nodes in the tree, 0 if empty
+ */
+
+int BinTree::size() const {
+    return nodeSize(root);
+}
+
+
+// Order Statistics ////////////////////////////////////////////////////////////////
+
+/**
+ * select ----------------------------------------------------------------------
+ * select : returns the NodeData at inorder position k, steering by the cached subtree sizes so only one
+ * root-to-node path is walked
+ *
+ * @param k : inorder position, 0 for the smallest NodeData
+ * pre: none
+ * post: tree is unchanged
+ * @return: the NodeData at position k, or NULL if k < 0 or k >= size()
+ */
+
+const NodeData* BinTree::select(int k) const {
+    Node* cur = root;
+    while (cur != NULL) {
+        int leftSize = nodeSize(cur->left);
+        if (k < leftSize) {                     // position is in left subtree
+            cur = cur->left;
+        } else if (k == leftSize) {             // found
+            return cur->data;
+        } else {                                // skip left subtree and cur
+            k -= leftSize + 1;
+            cur = cur->right;
+        }
+    }
+    return NULL;                                // out of range
+}
+
+
+/**
+ * rank ------------------------------------------------------------------------
+ * rank : returns the number of NodeData in the tree less than key, so select(rank(key)) == key when key is in
+ * the tree
+ *
+ * @param key : value to be ranked, need not be in the tree
+ * pre: key must be able to be comparable
+ * post: tree is unchanged
+ * @return: the count of NodeData less than key
+ */
+
+int BinTree::rank(const NodeData &key) const {
+    return countBelow(key, false);
+}
+
+
+/**
+ * countRange ------------------------------------------------------------------
+ * countRange : returns the number of NodeData within [lo, hi] inclusive, from two root-to-leaf descents
+ *
+ * @param lo : smallest value counted
+ * @param hi : largest value counted
+ * pre: lo and hi must be able to be comparable
+ * post: tree is unchanged
+ * @return: the count of NodeData x with lo <= x <= hi, 0 if hi < lo
+ */
+
+int BinTree::countRange(const NodeData &lo, const NodeData &hi) const {
+    if (hi < lo) {
+        return 0;
+    }
+    return countBelow(hi, true) - countBelow(lo, false);
+}
+
+
+/**
+ * countBelow ------------------------------------------------------------------
+ * countBelow : descends toward key, adding the size of every left subtree (plus its parent) passed on the right
+ *
+ * @param key : value to be compared against
+ * @param inclusive : true to also count a NodeData equal to key
+ * pre: key must be able to be comparable
+ * post: tree is unchanged
+ * @return: the count of NodeData less than key (or less than or equal, if inclusive)
+ */
+
+int BinTree::countBelow(const NodeData &key, bool inclusive) const {
+    int count = 0;
+    Node* cur = root;
+    while (cur != NULL) {
+        int order = key.compare(*cur->data);
+        if (order < 0 || (!inclusive && order == 0)) {
+            cur = cur->left;                    // cur and right are not below
+        } else {                                // cur and left are below
+            count += nodeSize(cur->left) + 1;
+            cur = cur->right;
+        }
+    }
+    return count;
+}
+
+
+// Using Arrays ////////////////////////////////////////////////////////////////////
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  function to fill an array of NodeData using an inorder traversal of the tree. it leaves the tree empty.
+ *  The NodeData pointers are moved into the array rather than copied, so only the Nodes are deallocated.
+ *
+ *  @param newArray : array to be filled with inorder traversal of NodeData elements from tree
+ *  pre: newArray must have room for size() elements
+ *  post: tree will be emptied and newArray filled with the tree's own NodeData elements in inorder traversal
+ */
+
+void BinTree::bstreeToArray(NodeData* newArray[]) {
+    bstreeToArray(newArray, size());
+}
+
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  overloaded function to move the NodeData of the tree into a caller-sized array in inorder order,
+ *  leaving the tree empty. Ownership of each NodeData passes to the caller; the Nodes are released a slab at a time.
+ *  While a copy of this tree shares its Nodes, the caller gets copies of the NodeData instead.
+ *
+ *  @param newArray : array to be filled with inorder traversal of NodeData elements from tree
+ *  @param capacity : number of elements newArray has room for
+ *  pre: none
+ *  post: if size() <= capacity, tree is emptied and the first size() elements of newArray hold its NodeData;
+ *  otherwise both are unchanged
+ *  @return: the number of NodeData written to newArray
+ */
+
+int BinTree::bstreeToArray(NodeData* newArray[], int capacity) {
+    int count = size();
+    if (count > capacity) {     // does not fit, leave everything alone
+        return 0;
+    }
+    bool shared = isShared();   // snapshots keep their own NodeData
+    int index = 0;              // helper veriable to determine position in array
+    for (const_iterator it = begin(); it != end(); ++it) {
+        NodeData* data = it.path.back()->data;
+        newArray[index] = shared ? new NodeData(*data) : data; // hand over
+        index++;                                    // Next position in array
+    }
+    if (shared) {
+        makeEmpty();
+    } else if (pool) {
+        pool->discard();        // NodeData now belong to the caller
+    }
+    root = NULL;
+    return count;
+}
+
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  overloaded function to append the NodeData of the tree to a vector in inorder order, leaving
+ *  the tree empty. Ownership of each NodeData passes to the caller.
+ *
+ *  @param newArray : vector the NodeData are appended to
+ *  pre: none
+ *  post: tree is emptied and newArray ends with its NodeData in inorder traversal
+ */
+
+void BinTree::bstreeToArray(vector<NodeData*> &newArray) {
+    size_t start = newArray.size();
+    newArray.resize(start + size());
+    bstreeToArray(newArray.data() + start, size());
+}
+
+
+/**
+*  arraytoBSTree --------------------------------------------------------------------------------------------------------------------------------
+*  arraytoBSTree :  function to build a balanced BinTree from a sorted array of NodeData* elements, leaving the
+*  array filled with NULLS.
+*
+*  @param oldArray : 100-element NodeData array to be used to build BinTree. Elements taken will be replaced with NULL
+*  pre: NodeData array must be a statically-located array of size 100
+*  post: this will be emptied and replaced with a balanced BinTree made of elements from oldArray,
+*  which will be filled with NULLs
+*/
+
+void BinTree::arrayToBSTree(NodeData* oldArray[]) {
+    int high = 0;                       // creates bounds of array to be searched
+    for (int i = 0; i < 100; i++) {     // find highest index of NodeData in array
+        if (oldArray[i] != NULL) {
+            high++;
+        }
+    }
+    arrayToBSTree(oldArray, high);
+}
+
+
+/**
+*  arraytoBSTree --------------------------------------------------------------------------------------------------------------------------------
+*  arraytoBSTree :  overloaded function to build a balanced BinTree from the first count elements of a sorted array
+*  of NodeData* elements, leaving those elements NULL. Nodes are linked directly without comparisons, so the build
+*  is linear in count.
+*
+*  @param oldArray : sorted NodeData array to be used to build BinTree. Elements taken will be replaced with NULL
+*  @param count : number of leading elements of oldArray to use
+*  pre: the first count elements of oldArray are non-NULL, sorted and distinct
+*  post: this will be emptied and replaced with a balanced BinTree made of elements from oldArray,
+*  which will be filled with NULLs
+*/
+
+void BinTree::arrayToBSTree(NodeData* oldArray[], int count) {
+    makeEmpty();
+    if (!pool) {
+        pool = make_shared<NodePool>();
+    }
+    pool->reserve(count);               // every Node comes from one slab
+    root = arrayToBSTreeHelper(oldArray, 0, count - 1);
+}
+
+
+/**
+*  arraytoBSTreeHelper --------------------------------------------------------------------------------------------------------------------------------
+*  arraytoBSTreeHelper : recursive helpr function for arrayToBSTree, to  build a balanced BinTree from a sorted array of
+*  NodeData* elements, leaving the array filled with NULLS. The middle element becomes the subtree root and each half
+*  becomes one of its children, so heights and sizes are known without rebalancing.
+*
+*  @param oldArray : sorted NodeData array to be used to build BinTree. Elements taken will be replaced with NULL
+* @param low : lowest subscript of the array range
+* @param high : highest subscript of the array range
+*  pre: elements low..high of oldArray are non-NULL, sorted and distinct
+*  post: elements from oldArray will be used to create a balanced BinTree, and afterward will be filled with NULLs
+*  @return: root of the subtree built from low..high, NULL if the range is empty
+*/
+
+BinTree::Node* BinTree::arrayToBSTreeHelper(NodeData* oldArray[], int low, int high) {
+    if (high < low) {
+        return NULL;
+    }
+    int midIndex = low + (high - low) / 2;
+    Node* cur = newNode();
+    cur->data = oldArray[midIndex];
+    oldArray[midIndex] = NULL;
+    cur->left = arrayToBSTreeHelper(oldArray, low, midIndex - 1);
+    cur->right = arrayToBSTreeHelper(oldArray, midIndex + 1, high);
+    updateNode(cur);
+    return cur;
+}
+
+
+/**
+*  bulkLoad --------------------------------------------------------------------------------------------------------------------------------
+*  bulkLoad : empties this tree and builds a balanced BinTree from items in linear time after an optional sort.
+*  A stable sort is used, so among equal NodeData the earliest one is kept, matching what repeated inserts would do.
+*
+*  @param items : NodeData to be placed in the tree; on return holds only the rejected duplicates
+*  @param sorted : true if items is already in ascending order, so no sort is needed
+*  pre: every element of items is non-NULL; if sorted is true, items is in ascending order
+*  post: this holds one NodeData per distinct value and owns them; duplicates are left in items for the caller
+*  @return: the number of NodeData in the tree
+*/
+
+int BinTree::bulkLoad(vector<NodeData*> &items, bool sorted) {
+    if (!sorted) {
+        stable_sort(items.begin(), items.end(),
+                    [](const NodeData* lhs, const NodeData* rhs) { return *lhs < *rhs; });
+    }
+    vector<NodeData*> distinct;
+    vector<NodeData*> rejected;
+    distinct.reserve(items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        if (!distinct.empty() && *distinct.back() == *items[i]) {
+            rejected.push_back(items[i]);       // duplicate, caller deletes
+        } else {
+            distinct.push_back(items[i]);
+        }
+    }
+    items.swap(rejected);
+    arrayToBSTree(distinct.data(), (int)distinct.size());
+    return size();
+}
+
+
+/**
+*  insertBatch --------------------------------------------------------------------------------------------------------------------------------
+*  insertBatch : merges items into this tree. After a stable sort of items, the tree is flattened in order, the two
+*  sorted runs are merged, dropping every item equal to a NodeData already kept, and the result is rebuilt as a
+*  balanced tree, so the whole batch costs one pass over both. When items * height() is less than size(), a
+*  descent per item is cheaper than touching every Node, so the items are inserted one at a time instead.
+*
+*  @param items : NodeData to be added; on return holds only the rejected duplicates
+*  @param sorted : true if items is already in ascending order, so no sort is needed
+*  pre: every element of items is non-NULL; if sorted is true, items is in ascending order
+*  post: this holds its previous NodeData plus one per new distinct value of items; NodeData already in the tree
+*  are kept over equal items, and earlier items over later equal ones
+*  @return: the number of NodeData added to the tree
+*/
+
+int BinTree::insertBatch(vector<NodeData*> &items, bool sorted) {
+    if (!sorted) {
+        stable_sort(items.begin(), items.end(),
+                    [](const NodeData* lhs, const NodeData* rhs) { return *lhs < *rhs; });
+    }
+    vector<NodeData*> rejected;
+    int added = 0;
+    if ((long long)items.size() * height() < size()) {  // few items, descend each
+        for (size_t i = 0; i < items.size(); i++) {
+            if (insert(items[i])) {
+                added++;
+            } else {
+                rejected.push_back(items[i]);   // duplicate, caller deletes
+            }
+        }
+        items.swap(rejected);
+        return added;
+    }
+    
+    vector<NodeData*> existing;
+    bstreeToArray(existing);
+    vector<NodeData*> merged;
+    merged.reserve(existing.size() + items.size());
+    size_t next = 0;                            // next existing NodeData
+    for (size_t i = 0; i < items.size(); i++) {
+        int order = -1;
+        while (next < existing.size() && (order = existing[next]->compare(*items[i])) < 0) {
+            merged.push_back(existing[next++]);
+        }
+        if ((next < existing.size() && order == 0)
+            || (!merged.empty() && *merged.back() == *items[i])) {
+            rejected.push_back(items[i]);       // duplicate, caller deletes
+        } else {
+            merged.push_back(items[i]);
+            added++;
+        }
+    }
+    merged.insert(merged.end(), existing.begin() + next, existing.end());
+    items.swap(rejected);
+    arrayToBSTree(merged.data(), (int)merged.size());
+    return added;
+}
+
+
+/**
+*  save --------------------------------------------------------------------------------------------------------------------------------
+*  save : writes the tree in the format read by MappedBinTree: a header, then the offset of each NodeData's
+*  characters, then the characters themselves, packed in order. The offsets and characters are gathered first so the
+*  checksum in the header can be computed before anything is written.
+*
+*  @param path : file to be written, replaced if it exists
+*  pre: none
+*  post: BinTree remains unchanged
+*  @return: true if the whole file was written
+*/
+
+bool BinTree::save(const string &path) const {
+    vector<uint64_t> offsets;
+    string keys;
+    offsets.reserve(size() + 1);
+    for (const_iterator it = begin(); it != end(); ++it) {
+        offsets.push_back(keys.size());
+        keys += it->getData();
+    }
+    offsets.push_back(keys.size());
+    
+    MappedBinTree::FileHeader header;
+    header.magic = MappedBinTree::MAGIC;
+    header.version = MappedBinTree::VERSION;
+    header.count = offsets.size() - 1;
+    header.keyBytes = keys.size();
+    header.checksum = MappedBinTree::checksum(offsets.data(), offsets.size() * sizeof(uint64_t),
+                                              MappedBinTree::CHECKSUM_SEED);
+    header.checksum = MappedBinTree::checksum(keys.data(), keys.size(), header.checksum);
+    
+    ofstream file(path.c_str(), ios::binary | ios::trunc);
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+    file.write(keys.data(), keys.size());
+    file.close();
+    return !file.fail();
+}
+
+
+/**
+*  load --------------------------------------------------------------------------------------------------------------------------------
+*  load : maps the file with a MappedBinTree, which checks it, and materializes it into this tree
+*
+*  @param path : file written by save
+*  pre: none
+*  post: on success this holds a balanced BinTree of the file's NodeData; on failure this is unchanged
+*  @return: true if the file was loaded
+*/
+
+bool BinTree::load(const string &path) {
+    MappedBinTree file;
+    if (!file.open(path)) {
+        return false;
+    }
+    file.materialize(*this);
+    return true;
+}
+
+
+/**
+ * displaySideways ------------------------------------------------------------------------------------------------------------------------
+ * Displays a binary tree as though you are viewing it from the side; hard coded displaying to standard output.
+ * Preconditions: NONE
+ * Postconditions: BinTree remains unchanged.
+ */
+
+void BinTree::displaySideways() const {
+    displaySideways(cout);
+}
+
+/**
+ * displaySideways ------------------------------------------------------------------------------------------------------------------------
+ * overloaded displaySideways : Displays a binary tree as though you are viewing it from the side, one Node per line
+ * from the largest down, indented 4 spaces per depth level. The walk is a reverse inorder traversal with an explicit
+ * stack, so any shape of tree can be shown, and the lines are gathered in an OutputBuffer with no flush per Node.
+ * A subtree rooted deeper than maxDepth is shown as one line giving its size, and once maxLines lines are written
+ * a last line gives the number of Nodes not yet shown.
+ * Preconditions: NONE
+ * Postconditions: BinTree remains unchanged.
+ * @param out : stream to be written to
+ * @param maxDepth : deepest level shown, the root being level 1; 0 for no limit
+ * @param maxLines : most lines written before the rest is summarized; 0 for no limit
+ */
+
+void BinTree::displaySideways(ostream &out, int maxDepth, int maxLines) const {
+    OutputBuffer buffer(out);
+    vector<pair<const Node*, int> > pending;   // Nodes waiting, with levels
+    const Node* cur = root;
+    int level = 1;
+    int lines = 0;
+    int shown = 0;                              // Nodes printed or summarized
+    for (;;) {
+        while (cur != NULL && (maxDepth == 0 || level <= maxDepth)) {
+            pending.push_back(make_pair(cur, level));
+            cur = cur->right;
+            level++;
+        }
+        bool cut = cur != NULL;                 // subtree below maxDepth
+        if (!cut) {
+            if (pending.empty()) {
+                break;
+            }
+            cur = pending.back().first;
+            level = pending.back().second;
+            pending.pop_back();
+        }
+
+        // indent for readability, 4 spaces per depth level
+        buffer.indent(level + 1);
+        if (maxLines > 0 && lines == maxLines) {
+            buffer.append("... " + to_string(size() - shown) + " more\n");
+            break;
+        }
+        if (cut) {
+            buffer.append("... " + to_string(cur->size) + " more\n");
+            shown += cur->size;
+            cur = NULL;
+        } else {
+            cur->data->appendTo(buffer);          // display information of object
+            buffer.append('\n');
+            shown++;
+            cur = cur->left;
+            level++;
+        }
+        lines++;
+    }
+}
+
+// Helpers
+
+/**
+ * isEmpty ----------------------------------------------------------------------------------------------------------------------------------
+ * Function to determine if BinTree is empty or not, returning the bool value of emptiness
+ * Pre: none
+ * Post: returns true if BinTree is empty, meaning it contains no Node objects, false if not
+ */
+bool BinTree::isEmpty() const {
+    if (root == NULL) {
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * isBalanced -------------------------------------------------------------------------------------------------------------------------------
+ * Function to determine if this BinTree rebalances itself on insert and remove
+ * Pre: none
+ * Post: returns true if this BinTree was constructed as self-balancing, false if not
+ */
+bool BinTree::isBalanced() const {
+    return balanced;
+}
+
+
+// Iterators ////////////////////////////////////////////////////////////////////
+
+/**
+ * begin ------------------------------------------------------------------------------------------------------------------------------------
+ * begin : returns an iterator to the smallest NodeData in the tree, or end() if the tree is empty
+ */
+
+BinTree::const_iterator BinTree::begin() const {
+    const_iterator it(root);
+    it.pushLeftmost(root);
+    return it;
+}
+
+
+/**
+ * end --------------------------------------------------------------------------------------------------------------------------------------
+ * end : returns the iterator one past the largest NodeData in the tree
+ */
+
+BinTree::const_iterator BinTree::end() const {
+    return const_iterator(root);
+}
+
+
+/**
+ * lower_bound ------------------------------------------------------------------------------------------------------------------------------
+ * lower_bound : returns an iterator to the first NodeData not less than key, found with a single descent
+ *
+ * @param key : value to search for
+ * pre: key must be able to be comparable
+ * post: tree is unchanged
+ * @return: iterator to the first NodeData >= key, or end() if none
+ */
+
+BinTree::const_iterator BinTree::lower_bound(const NodeData &key) const {
+    const_iterator it(root);
+    size_t keep = 0;                            // path length to best candidate
+    Node* cur = root;
+    while (cur != NULL) {
+        it.path.push_back(cur);
+        if (*cur->data < key) {                 // too small, answer is right
+            cur = cur->right;
+        } else {                                // candidate, look for smaller
+            keep = it.path.size();
+            cur = cur->left;
+        }
+    }
+    it.path.resize(keep);
+    return it;
+}
+
+
+/**
+ * upper_bound ------------------------------------------------------------------------------------------------------------------------------
+ * upper_bound : returns an iterator to the first NodeData greater than key, found with a single descent
+ *
+ * @param key : value to search for
+ * pre: key must be able to be comparable
+ * post: tree is unchanged
+ * @return: iterator to the first NodeData > key, or end() if none
+ */
+
+BinTree::const_iterator BinTree::upper_bound(const NodeData &key) const {
+    const_iterator it(root);
+    size_t keep = 0;                            // path length to best candidate
+    Node* cur = root;
+    while (cur != NULL) {
+        it.path.push_back(cur);
+        if (key < *cur->data) {                 // candidate, look for smaller
+            keep = it.path.size();
+            cur = cur->left;
+        } else {                                // not greater, answer is right
+            cur = cur->right;
+        }
+    }
+    it.path.resize(keep);
+    return it;
+}
+
+
+/**
+ * const_iterator ---------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates an iterator not attached to any tree
+ */
+
+BinTree::const_iterator::const_iterator() {
+    root = NULL;
+}
+
+
+/**
+ * const_iterator ---------------------------------------------------------------------------------------------------------------------------
+ * Constructor : creates an end() iterator over the tree rooted at treeRoot
+ */
+
+BinTree::const_iterator::const_iterator(Node* treeRoot) {
+    root = treeRoot;
+}
+
+
+/**
+ * operator* / operator-> -------------------------------------------------------------------------------------------------------------------
+ * access the NodeData at the current position
+ * pre: iterator is not end()
+ */
+
+BinTree::const_iterator::reference BinTree::const_iterator::operator*() const {
+    return *path.back()->data;
+}
+
+BinTree::const_iterator::pointer BinTree::const_iterator::operator->() const {
+    return path.back()->data;
+}
+
+
+/**
+ * operator++ -------------------------------------------------------------------------------------------------------------------------------
+ * operator++ : moves to the next larger NodeData. If the current Node has a right subtree, the next Node is the
+ * smallest in it; otherwise it is the nearest ancestor whose left subtree holds the current Node.
+ * pre: iterator is not end()
+ * post: iterator refers to the inorder successor, or end() after the largest NodeData
+ */
+
+BinTree::const_iterator& BinTree::const_iterator::operator++() {
+    Node* cur = path.back();
+    if (cur->right != NULL) {
+        pushLeftmost(cur->right);
+    } else {
+        Node* child;
+        do {                                    // climb while coming from right
+            child = path.back();
+            path.pop_back();
+        } while (!path.empty() && path.back()->right == child);
+    }
+    return *this;
+}
+
+BinTree::const_iterator BinTree::const_iterator::operator++(int) {
+    const_iterator before = *this;
+    ++(*this);
+    return before;
+}
+
+
+/**
+ * operator-- -------------------------------------------------------------------------------------------------------------------------------
+ * operator-- : moves to the next smaller NodeData, the mirror image of operator++
+ * pre: iterator is not begin()
+ * post: iterator refers to the inorder predecessor; end() moves to the largest NodeData
+ */
+
+BinTree::const_iterator& BinTree::const_iterator::operator--() {
+    if (path.empty()) {                         // end(), back up to largest
+        pushRightmost(root);
+        return *this;
+    }
+    Node* cur = path.back();
+    if (cur->left != NULL) {
+        pushRightmost(cur->left);
+    } else {
+        Node* child;
+        do {                                    // climb while coming from left
+            child = path.back();
+            path.pop_back();
+        } while (!path.empty() && path.back()->left == child);
+    }
+    return *this;
+}
+
+BinTree::const_iterator BinTree::const_iterator::operator--(int) {
+    const_iterator before = *this;
+    --(*this);
+    return before;
+}
+
+
+/**
+ * operator== / operator!= ------------------------------------------------------------------------------------------------------------------
+ * true if both iterators refer to the same Node, or are both end()
+ */
+
+bool BinTree::const_iterator::operator==(const const_iterator &rhs) const {
+    Node* lhsNode = path.empty() ? NULL : path.back();
+    Node* rhsNode = rhs.path.empty() ? NULL : rhs.path.back();
+    return lhsNode == rhsNode;
+}
+
+bool BinTree::const_iterator::operator!=(const const_iterator &rhs) const {
+    return !(*this == rhs);
+}
+
+
+/**
+ * pushLeftmost / pushRightmost -------------------------------------------------------------------------------------------------------------
+ * extends the path from cur down to the smallest / largest Node of its subtree
+ */
+
+void BinTree::const_iterator::pushLeftmost(Node* cur) {
+    while (cur != NULL) {
+        path.push_back(cur);
+        cur = cur->left;
+    }
+}
+
+void BinTree::const_iterator::pushRightmost(Node* cur) {
+    while (cur != NULL) {
+        path.push_back(cur);
+        cur = cur->right;
     }
-    return false;
 }
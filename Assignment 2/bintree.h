@@ -13,49 +13,106 @@
 //  Assumptions:
 //     -- Input assumed to be correct and consist of NodeData objects, to be
 //        implemented by client
-//     -- BSTs and arrays produced are assumed to be no more than 100 nodes,
-//        and any index not referencing a BinTree node should be NULL
+//     -- Arrays given to bstreeToArray must have room for every Node of the
+//        tree; the single-argument arrayToBSTree reads 100 slots, and any
+//        index not referencing a BinTree node should be NULL
+//     -- NodeData reached through an iterator, select, retrieveBatch or the
+//        const retrieve may be shared with copies of the tree, so it must
+//        not be modified
+//     -- Copies may be used and destroyed on different threads, but one
+//        tree must still not be modified by two threads at once
 
 #ifndef BINTREE_H
 #define BINTREE_H
 #include <stdio.h>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include "nodedata.h"
 using namespace std;
 
 class BinTree {
 
     // operator<< -------------------------------------------------------
-    // Prints an inorder traversal of the tree
+    // Prints an inorder traversal of the tree to out, followed by endl
     friend ostream& operator<<(ostream &out, const BinTree &);
     
 public:
+    // Iterators ///////////////////////////////////////////////////////////
+    
+    // const_iterator --------------------------------------------------------
+    // bidirectional inorder iterator over the NodeData of a BinTree, defined
+    // below the class. The NodeData it refers to may not be modified, since
+    // that could break the ordering of the tree. It walks without recursion,
+    // so trees of any shape can be traversed, and insert and remove
+    // invalidate it
+    class const_iterator;
+    typedef const_iterator iterator;
+    
     // Constructor/Destructor //////////////////////////////////////////////
     
     // BinTree ---------------------------------------------------------
     // Default Constructor : creates an empty BinTree and sets root to NULL
     BinTree();
     
+    // BinTree ---------------------------------------------------------
+    // Constructor : creates an empty BinTree and sets root to NULL. If
+    // balanced is true, the tree rebalances itself (AVL) on insert/remove,
+    // keeping its height O(log n) even when input arrives in sorted order
+    explicit BinTree(bool balanced);
+    
     // BinTree ----------------------------------------------------------
-    // Copy Constructor : creates a BinTree and creates a deep copy of the
-    // inputTree, setting it to this
+    // Copy Constructor : creates a BinTree holding a snapshot of inputTree
+    // in O(1) by sharing its Nodes; later changes to either tree copy only
+    // the Nodes on the path they touch. Nodes are reference counted, and
+    // the slabs they come from are shared by all copies until the last one
+    // lets go
     BinTree(const BinTree &);
     
+    // BinTree ----------------------------------------------------------
+    // Copy Constructor : creates an independent deep copy of inputTree
+    // using up to the given number of threads, forking subtrees of at
+    // least PARALLEL_THRESHOLD Nodes onto their own thread. The copy is
+    // identical to the one a single thread makes
+    BinTree(const BinTree &, int threads);
+    
+    // BinTree ----------------------------------------------------------
+    // Move Constructor : takes over the Nodes of inputTree in O(1), leaving
+    // inputTree empty
+    BinTree(BinTree &&) noexcept;
+    
     // ~BinTree ----------------------------------------------------------
-    // Destructor : Deallocates all nodes of BinTree and sets root to NULL
+    // Destructor : Deallocates all nodes of BinTree and sets root to NULL,
+    // releasing the slabs the Nodes came from a slab at a time
     ~BinTree();
     
     
     // Assignment Operators ////////////////////////////////////////////////
     
     // operator= --------------------------------------------------------
-    // overloaded =: true if this BinTree != parameter BinTree, false if not
+    // overloaded =: makes this a snapshot of the parameter BinTree in O(1),
+    // sharing its Nodes, and releases what this held before
     BinTree& operator=(const BinTree &);
     
+    // operator= --------------------------------------------------------
+    // overloaded move =: deallocates this tree and takes over the Nodes of
+    // the parameter BinTree in O(1), leaving it empty
+    BinTree& operator=(BinTree &&) noexcept;
+    
+    // swap -------------------------------------------------------------
+    // exchanges the contents of this BinTree and the parameter in O(1)
+    void swap(BinTree &) noexcept;
+    
     
     // Equality Operators //////////////////////////////////////////////////
     
     // operator== ---------------------------------------------------------
-    // overloaded ==: true if this BinTree == parameter BinTree, false if not
+    // overloaded ==: true if this BinTree == parameter BinTree, false if not.
+    // Subtrees the two trees share are not walked
     bool operator==(const BinTree &) const;
     
     // operator!= ---------------------------------------------------------
@@ -68,26 +125,141 @@ public:
     // inserts a new Node containing the input newData into the BinTree object
     bool insert(NodeData*);
     
+    // remove ---------------------------------------------------------------
+    // removes the Node whose data equals the input from the BinTree object,
+    // deallocating its NodeData. Returns false if no such Node exists
+    bool remove(const NodeData &);
+    
     // makeEmpty ------------------------------------------------------------
     // deallocates all nodes of the BinTree object in this and sets root to NULL
     void makeEmpty();
+    
+    // makeEmpty ------------------------------------------------------------
+    // overloaded makeEmpty deallocates all nodes using up to the given
+    // number of threads, splitting the work only for trees of at least
+    // PARALLEL_THRESHOLD Nodes
+    void makeEmpty(int threads);
+    
+    // split ----------------------------------------------------------------
+    // moves every NodeData less than the given value into left and the rest
+    // into right, leaving this tree empty, in O(log n) if this tree is
+    // balanced. What left and right held before is deallocated; either may
+    // be this tree, but not both. Nodes are moved rather than copied, and
+    // the two halves share one pool
+    void split(const NodeData &, BinTree &left, BinTree &right);
+    
+    // join -----------------------------------------------------------------
+    // makes this tree hold every NodeData of left and right, leaving them
+    // empty, in O(log n) if both are balanced. Returns false, changing
+    // nothing, unless every NodeData of left is less than every NodeData of
+    // right. Either may be this tree, but not both. Joining trees from
+    // different pools keeps both pools alive for as long as the result
+    bool join(BinTree &left, BinTree &right);
+    
+    // unite ----------------------------------------------------------------
+    // adds every NodeData of the given tree to this one, in O(m log(n/m+1))
+    // for balanced trees of sizes m <= n, linking the given tree's Nodes in
+    // rather than copying them where it can. Like intersect and subtract, it
+    // recurses as deep as the given tree is tall, so that tree should be
+    // balanced if it is large
+    void unite(const BinTree &);
+    
+    // overloaded unite uses up to the given number of threads
+    void unite(const BinTree &, int threads);
+    
+    // intersect ------------------------------------------------------------
+    // removes every NodeData not in the given tree, in O(m log(n/m+1))
+    void intersect(const BinTree &);
+    
+    // overloaded intersect uses up to the given number of threads
+    void intersect(const BinTree &, int threads);
+    
+    // subtract -------------------------------------------------------------
+    // removes every NodeData in the given tree, in O(m log(n/m+1))
+    void subtract(const BinTree &);
+    
+    // overloaded subtract uses up to the given number of threads
+    void subtract(const BinTree &, int threads);
+    
+    // PARALLEL_THRESHOLD ---------------------------------------------------
+    // smallest subtree worth handing to its own thread when copying,
+    // emptying or combining trees
+    static const int PARALLEL_THRESHOLD = 1 << 15;
 
     
     // Accessors ///////////////////////////////////////////////////////////
     
     // retrieve ------------------------------------------------------------
     // returns the bool value of whether data desired is in this tree, modifying
-    // the dataRetrieved directly to be NodeData object, if found
+    // the dataRetrieved directly to be NodeData object, if found. The NodeData
+    // is first made this tree's own, so changing it changes no copy
     bool retrieve(const NodeData &, NodeData* &);
     
+    // overloaded retrieve sets a read-only pointer and changes nothing
+    bool retrieve(const NodeData &, const NodeData* &) const;
+    
+    // retrieveBatch --------------------------------------------------------
+    // looks up count values at once, setting found[i] to the NodeData equal
+    // to probes[i], or NULL. Up to BATCH_LANES descents are interleaved and
+    // prefetch ahead, so their cache misses overlap. Returns how many found
+    int retrieveBatch(const NodeData [], int, const NodeData* []) const;
+    
     // getHeight ------------------------------------------------------------
     // returns the height of a general tree of a given value.
     int getHeight (const NodeData &) const;
+    
+    // height ---------------------------------------------------------------
+    // returns the height of the whole tree, 0 if empty
+    int height() const;
+    
+    // size -----------------------------------------------------------------
+    // returns the number of NodeData objects in the tree
+    int size() const;
+    
+    
+    // Order Statistics ////////////////////////////////////////////////////
+    
+    // select ---------------------------------------------------------------
+    // returns the NodeData at inorder position k (0 is the smallest, the
+    // same index bstreeToArray would use), or NULL if k is out of range
+    const NodeData* select(int) const;
+    
+    // rank -----------------------------------------------------------------
+    // returns the number of NodeData in the tree less than the given value,
+    // which is its inorder position if it is in the tree
+    int rank(const NodeData &) const;
+    
+    // countRange -----------------------------------------------------------
+    // returns the number of NodeData in the tree within [lo, hi] inclusive
+    int countRange(const NodeData &, const NodeData &) const;
+    
+    // rangeScan ------------------------------------------------------------
+    // calls visit(const NodeData &) on each NodeData within [lo, hi]
+    // inclusive, in order, touching only those Nodes and the path to lo
+    template <class Visitor>
+    void rangeScan(const NodeData &, const NodeData &, Visitor) const;
 
     // isEmpty ---------------------------------------------------------------
     // true if tree is empty, otherwise
     bool isEmpty() const;
     
+    // isBalanced ------------------------------------------------------------
+    // true if this tree rebalances itself on insert/remove, otherwise false
+    bool isBalanced() const;
+    
+    // begin / end ------------------------------------------------------------
+    // iterators to the smallest NodeData and to one past the largest
+    const_iterator begin() const;
+    const_iterator end() const;
+    
+    // lower_bound -------------------------------------------------------------
+    // iterator to the first NodeData not less than the given value, or end()
+    const_iterator lower_bound(const NodeData &) const;
+    
+    // upper_bound -------------------------------------------------------------
+    // iterator to the first NodeData greater than the given value, or end()
+    const_iterator upper_bound(const NodeData &) const;
+    
     
     // Output Functions /////////////////////////////////////////////////////
     
@@ -96,17 +268,69 @@ public:
     // hard coded displaying to standard output.
     void displaySideways() const;
     
+    // displaySideways -----------------------------------------------------
+    // overloaded displaySideways writes to the given stream. Subtrees below
+    // maxDepth levels, and everything after maxLines lines, are each shown
+    // as one "... n more" line; 0 means no limit
+    void displaySideways(ostream &, int maxDepth = 0, int maxLines = 0) const;
+    
     // bstreeToArray  -------------------------------------------------------
     // function to fill an array of NodeData using an inorder traversal of the
-    // tree. it leaves the tree empty, and the NodeData array passted in a
-    // statically-located array of 100 NULL elements.
+    // tree. The NodeData themselves are handed over, not copied, and the tree
+    // is left empty. The array must have room for size() elements.
     void bstreeToArray(NodeData* []);
     
+    // bstreeToArray  -------------------------------------------------------
+    // overloaded bstreeToArray hands over the NodeData into an array of the
+    // given capacity, returning how many were written. If the tree does not
+    // fit, nothing is moved, the tree is unchanged, and 0 is returned
+    int bstreeToArray(NodeData* [], int);
+    
+    // bstreeToArray  -------------------------------------------------------
+    // overloaded bstreeToArray appends the NodeData to a vector in order,
+    // handing them over and leaving the tree empty
+    void bstreeToArray(vector<NodeData*> &);
+    
     // arraytoBSTree -----------------------------------------------------
     // function to build a balanced BinTree from a sorted array of NodeData*
     // elements, leaving the array filled with NULLS.
     void arrayToBSTree(NodeData* []);
     
+    // arraytoBSTree -----------------------------------------------------
+    // overloaded arrayToBSTree builds a balanced BinTree from the first count
+    // elements of a sorted array of any length in linear time, leaving them
+    // NULL
+    void arrayToBSTree(NodeData* [], int);
+    
+    // bulkLoad -------------------------------------------------------------
+    // empties this tree and builds a balanced tree from the given NodeData*
+    // in linear time, sorting them first unless sorted is true. The tree takes
+    // ownership of every NodeData it keeps; duplicates are left in the vector
+    // for the caller to delete, just as insert returns false for them.
+    // Returns the number of NodeData now in the tree
+    int bulkLoad(vector<NodeData*> &, bool sorted = true);
+    
+    // insertBatch ----------------------------------------------------------
+    // adds the given NodeData* to the tree, keeping what it holds. The batch
+    // is sorted (unless sorted is true) and deduplicated, then merged with
+    // the tree's own NodeData in one pass and rebuilt balanced; a batch too
+    // small to be worth a rebuild is inserted one at a time instead. As with
+    // bulkLoad, the vector is left holding the duplicates, which the caller
+    // deletes. Returns the number of NodeData added
+    int insertBatch(vector<NodeData*> &, bool sorted = false);
+    
+    // save -----------------------------------------------------------------
+    // writes the tree's NodeData in order to a binary file that
+    // MappedBinTree can search in place; returns false if it cannot be
+    // written
+    bool save(const string &) const;
+    
+    // load -----------------------------------------------------------------
+    // empties this tree and rebuilds it balanced from a file written by
+    // save, in linear time. Returns false, leaving the tree unchanged, if
+    // the file is missing or fails its checks
+    bool load(const string &);
+    
 private:
     
     // Custom structure for Nodes to be used in BinTree
@@ -114,68 +338,327 @@ private:
         NodeData* data;                        // pointer to data object
         Node* left;                            // left subtree pointer
         Node* right;                           // right subtree pointer
+        int height;                            // height of subtree, leaf is 1
+        int size;                              // number of Nodes in subtree
+        atomic<int> refs;                      // links to this Node, from
+                                               // parents or tree roots
     };
+    
+    // Arena of Nodes shared by a BinTree and its copies. Nodes are carved out of slabs
+    // that grow geometrically, and removed Nodes are recycled through a
+    // free list, so a whole tree is released one slab at a time.
+    class NodePool {
+    public:
+        NodePool();
+        ~NodePool();
+        
+        // allocate: returns a Node with NULL data and children, height and
+        // size 1
+        Node* allocate();
+        
+        // release: returns one Node to the free list; data is not deleted
+        void release(Node*);
+        
+        // clear: deletes the NodeData of every live Node, then every slab,
+        // splitting the slabs across up to the given number of threads
+        void clear(int threads = 1);
+        
+        // reserve: makes sure the current slab has room for count more Nodes
+        void reserve(int);
+        
+        // discard: deallocates every slab without touching any NodeData,
+        // for when the NodeData have been handed to someone else
+        void discard();
+        
+        // absorb: takes over every slab and free Node of another pool,
+        // leaving it empty
+        void absorb(NodePool &);
+        
+        // adopt: keeps another pool, and the Nodes in it, alive as long as
+        // this one, for a tree that now links Nodes from both
+        void adopt(const shared_ptr<NodePool> &);
+        
+        // holds: true if this pool has adopted the given pool, directly or
+        // through another adopted pool
+        bool holds(const NodePool*);
+        
+        // heldElsewhere: true if a pool this one has adopted, directly or
+        // through another, is also held by something else; clears
+        // adoptedShared otherwise
+        bool heldElsewhere();
+        
+        mutex lock;                            // held to allocate or release
+                                               // while trees share the pool
+        atomic<bool> adoptedShared;            // true while a pool adopted
+                                               // may be held by another tree
+        
+    private:
+        NodePool(const NodePool &) = delete;
+        NodePool& operator=(const NodePool &) = delete;
+        
+        struct Slab {
+            Node* nodes;                       // contiguous block of Nodes
+            int capacity;                      // number of Nodes in block
+            int used;                          // Nodes handed out so far
+            Slab* next;                        // previously allocated slab
+        };
+        static const int MIN_SLAB = 16;        // first slab capacity
+        static const int MAX_SLAB = 4096;      // largest slab capacity
+        
+        Slab* slabs;                           // most recent slab first
+        Node* freeList;                        // released Nodes, via left
+        vector<shared_ptr<NodePool> > adopted; // pools whose Nodes this
+                                               // pool's trees may link
+    };
+    
+    // descents interleaved by retrieveBatch, and the smallest tree it
+    // interleaves on; below that the tree stays in cache anyway
+    static const int BATCH_LANES = 16;
+    static const int BATCH_THRESHOLD = 1 << 15;
+    
     Node* root;                                // root of the tree
+    bool balanced;                             // true if AVL rebalancing
+    bool concurrent;                           // true while a set operation
+                                               // runs on several threads
+    shared_ptr<NodePool> pool;                 // storage for this tree's Nodes,
+                                               // NULL until one is needed
 
     
     // Utility functions //////////////////////////////////////////////
         
     // inorderHelper -----------------------------------------------------
-    // helper for operator<< overloaded method by recursively moving through the BinTree
-    void inorderHelper(Node*) const;
+    // helper for operator<< overloaded method by iterating through the BinTree
+    void inorderHelper(ostream &) const;
     
-    // Sideways -----------------------------------------------------------
-    // Helper method for displaySideways
-    void sideways(Node*, int) const;
+    // duplicateTree -------------------------------------------------------
+    // iteratively copies nodes from rhs to lhs, duplicating entire tree,
+    // allocating the copies from the given pool
+    static void duplicateTree(Node* &, Node*, NodePool &);
     
-    // makeEmptyHelper ----------------------------------------------------
-    // helper function for makeEmpty. Deallocates all nodes of the BinTree
-    void makeEmptyHelper(Node* &);
+    // duplicateParallel ---------------------------------------------------
+    // copies nodes from rhs to lhs like duplicateTree, but forks the right
+    // subtree onto another thread (with its own pool, absorbed afterward)
+    // while threads remain and the subtree is at least PARALLEL_THRESHOLD
+    static void duplicateParallel(Node* &, Node*, NodePool &, int);
     
-    // duplicateTree -------------------------------------------------------
-    // recursively copies nodes from rhs to lhs, duplicating entire tree
-    void duplicateTree(Node* &, Node*);
+    // defaultThreads -------------------------------------------------------
+    // number of threads worth using on a tree of the given size: 1 below
+    // PARALLEL_THRESHOLD, otherwise the hardware concurrency
+    static int defaultThreads(int);
     
     // equalityHelper -----------------------------------------------------
-    // recursively compares rhs nodes to lhs, throughout entire tree
+    // iteratively compares rhs nodes to lhs, throughout entire tree
     bool equalityHelper(Node*, Node*) const;
     
     // insertHelper ---------------------------------------------------------
-    // Helper function for insert. Recursively inserts a new Node containing
-    // the input newData
+    // Helper function for insert. Walks down to the insertion point, links
+    // a new Node containing the input newData, then fixes the path upward
     bool insertHelper(Node* &, NodeData*);
     
+    // removeHelper ---------------------------------------------------------
+    // Helper function for remove. Walks down to the Node containing the
+    // target data, unlinks it, then fixes the path upward
+    bool removeHelper(Node* &, const NodeData &);
+    
+    // fixPath --------------------------------------------------------------
+    // rebalances each link of a root-to-leaf path from the bottom up
+    void fixPath(vector<Node**> &);
+    
+    // splitHelper ----------------------------------------------------------
+    // Helper function for split. Takes apart the given subtree into the
+    // Nodes less than the given value and the rest, optionally setting
+    // aside the Node equal to it
+    void splitHelper(Node*, const NodeData &, Node* &, Node* &, Node** = NULL);
+    
+    // joinHelper -----------------------------------------------------------
+    // joins two subtrees and a middle Node lying between them into one
+    // subtree, returning its root
+    Node* joinHelper(Node*, Node*, Node*);
+    
+    // joinTrees ------------------------------------------------------------
+    // joins two subtrees, every NodeData of the first less than those of the
+    // second, using the second's smallest Node as the middle
+    Node* joinTrees(Node*, Node*);
+    
+    // detachMin ------------------------------------------------------------
+    // unlinks the Node holding the smallest NodeData of a non-empty subtree
+    // and returns it with no children
+    Node* detachMin(Node* &);
+    
+    // uniteHelper ----------------------------------------------------------
+    // Helper function for unite. Returns the union of a subtree of this
+    // tree and a subtree of the other
+    Node* uniteHelper(Node*, Node*, int);
+    
+    // intersectHelper ------------------------------------------------------
+    // Helper function for intersect. Returns the Nodes of a subtree of this
+    // tree whose NodeData a subtree of the other tree holds too
+    Node* intersectHelper(Node*, Node*, int);
+    
+    // subtractHelper -------------------------------------------------------
+    // Helper function for subtract. Returns the Nodes of a subtree of this
+    // tree whose NodeData a subtree of the other tree does not hold
+    Node* subtractHelper(Node*, Node*, int);
+    
+    // combineHalves --------------------------------------------------------
+    // applies one of the three helpers above to both halves of a split,
+    // forking the upper half onto another thread while threads remain and
+    // the halves are at least PARALLEL_THRESHOLD Nodes
+    void combineHalves(Node* &, Node* &, Node*, int, Node* (BinTree::*)(Node*, Node*, int));
+    
+    // unsharePath ---------------------------------------------------------
+    // copies every Node on a root-to-leaf path (and the Node at the final
+    // link) that is shared with another tree, updating the path to match
+    void unsharePath(vector<Node**> &, Node** &);
+    
+    // makeUnique -----------------------------------------------------------
+    // replaces the Node at the given link with a private copy if another
+    // tree also links to it. Returns true if a copy was made
+    bool makeUnique(Node* &);
+    
+    // share ----------------------------------------------------------------
+    // adds one reference to the given Node (if not NULL) and returns it
+    static Node* share(Node*);
+    
+    // releaseTree ----------------------------------------------------------
+    // drops one reference to the given subtree, deallocating each Node (and
+    // its NodeData) that no tree links to any more
+    void releaseTree(Node*);
+    
+    // isShared / lockNeeded / newNode -------------------------------------
+    // whether another tree may link this tree's Nodes, whether the pool
+    // must be locked to allocate or release (while shared or concurrent),
+    // and a Node allocated from the pool, locking it if needed
+    bool isShared() const;
+    bool lockNeeded() const;
+    Node* newNode();
+    
+    // nodeHeight -----------------------------------------------------------
+    // returns the cached height of the given node, 0 if NULL
+    int nodeHeight(Node*) const;
+    
+    // nodeSize -------------------------------------------------------------
+    // returns the cached subtree size of the given node, 0 if NULL
+    int nodeSize(Node*) const;
+    
+    // updateNode -----------------------------------------------------------
+    // recomputes the cached height and size of the given node from its
+    // children
+    void updateNode(Node*);
+    
+    // rotateLeft / rotateRight --------------------------------------------
+    // single rotations used to restore the AVL balance of a subtree
+    void rotateLeft(Node* &);
+    void rotateRight(Node* &);
+    
+    // rebalance ------------------------------------------------------------
+    // updates the height and size of the given node and, if this tree is balanced,
+    // rotates the subtree so its children differ in height by at most one
+    void rebalance(Node* &);
+    
     // retrieveHelper -------------------------------------------------------
-    // recursive helper function for retrieve function. Returns the bool value
+    // iterative helper function for retrieve function. Returns the bool value
     // of whether data desired is in this tree,modifying the dataRetrieved
     // directly to be NodeData object, if found
-    bool retrieveHelper(Node* &, const NodeData &, NodeData* &) const;
+    bool retrieveHelper(Node* &, const NodeData &, const NodeData* &) const;
     
     // getHeightHelper ----------------------------------------------------
-    // recurisve helper function for getHeight. Returns the height of a
-    // general tree of a given value. Height of a leaf node is 1, and a value
-    // not found is 0.
+    // helper function for getHeight. Descends by the BST ordering to the
+    // given value and returns its cached height. Height of a leaf node is 1,
+    // and a value not found is 0.
     int getHeightHelper (Node*, const NodeData &) const;
     
+    // countBelow ---------------------------------------------------------
+    // returns the number of NodeData less than the given value, or less than
+    // or equal to it if inclusive is true
+    int countBelow(const NodeData &, bool) const;
+    
     // getHeight ----------------------------------------------------------
-    // overloaded getHeight recursively returns the height of a general tree
+    // overloaded getHeight returns the cached height of a general tree
     // of the given node. The height of a leaf node is 1, and cur == NULL
     // returns zero.
     int getHeight (Node*) const;
     
-    // bstreeToArrayHelper  ------------------------------------------------
-    // recursive helper function to bstToArray  to fill an array of NodeData
-    // using an inorder traversal of the tree. it leaves the tree empty,
-    // and the NodeData array passted in a statically-located array of 100
-    // NULL elements.
-    void bstreeToArrayHelper(NodeData* [], Node*, int&);
-    
     // arraytoBSTreeHelper -------------------------------------------------
     // recursive helpr function for arrayToBSTree, to  build a balanced BinTree
     // from a sorted array of NodeData* elements, leaving the array
-    // filled with NULLS.
-    void arrayToBSTreeHelper(NodeData* [], int, int);
+    // filled with NULLS. Links Nodes directly and returns the subtree root
+    Node* arrayToBSTreeHelper(NodeData* [], int, int);
         
 };
 
+
+// BinTree::const_iterator ////////////////////////////////////////////////////
+// Keeps the path from the root down to the current Node, so stepping forward
+// or backward needs no recursion and no parent pointers, and memory used is
+// bounded by the height of the tree. end() is represented by an empty path.
+
+class BinTree::const_iterator {
+    friend class BinTree;
+    
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef NodeData value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const NodeData* pointer;
+    typedef const NodeData& reference;
+    
+    // const_iterator ----------------------------------------------------
+    // Default Constructor : creates an iterator not attached to any tree
+    const_iterator();
+    
+    // operator* / operator-> --------------------------------------------
+    // access the NodeData at the current position; invalid at end()
+    reference operator*() const;
+    pointer operator->() const;
+    
+    // operator++ / operator-- -------------------------------------------
+    // move to the next larger / next smaller NodeData. Decrementing end()
+    // moves to the largest NodeData
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+    
+    // operator== / operator!= -------------------------------------------
+    // true if both iterators refer to the same Node (or both to end())
+    bool operator==(const const_iterator &) const;
+    bool operator!=(const const_iterator &) const;
+    
+private:
+    // const_iterator ----------------------------------------------------
+    // Constructor : creates an end() iterator over the tree with this root
+    explicit const_iterator(Node*);
+    
+    // pushLeftmost / pushRightmost ---------------------------------------
+    // extends the path from the given Node to the smallest / largest Node
+    // of its subtree
+    void pushLeftmost(Node*);
+    void pushRightmost(Node*);
+    
+    Node* root;                                // root of the tree walked
+    vector<Node*> path;                        // root..current, empty at end
+};
+
+
+// swap -----------------------------------------------------------------------
+// non-member swap so std algorithms and containers find it by lookup
+
+inline void swap(BinTree &lhs, BinTree &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+
+// rangeScan ------------------------------------------------------------------
+// Starts from lower_bound(lo) and steps forward until passing hi, so the cost
+// is one descent plus the number of NodeData visited.
+
+template <class Visitor>
+void BinTree::rangeScan(const NodeData &lo, const NodeData &hi,
+                        Visitor visit) const {
+    for (const_iterator it = lower_bound(lo); it != end() && !(hi < *it); ++it) {
+        visit(*it);
+    }
+}
+
 #endif
@@ -0,0 +1,102 @@
+//
+//  boundedqueue.h
+//
+//  BoundedQueue Object: a first-in first-out queue of at most a fixed number
+//  of items, shared by threads. push waits while the queue is full and pop
+//  waits while it is empty, so a fast producer is held back to the pace of
+//  its consumers instead of piling up work in memory. Closing the queue
+//  wakes everyone: pushes fail from then on, and pops drain what is left
+//  and then fail, which is how consumers learn the input is over.
+//
+//  Assumptions:
+//     -- T is movable; items are moved in and out, never copied
+//     -- The queue outlives every thread using it
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+using namespace std;
+
+template <class T>
+class BoundedQueue {
+
+public:
+    // BoundedQueue -------------------------------------------------------
+    // Constructor : creates an open, empty queue holding up to capacity
+    // items (at least one)
+    explicit BoundedQueue(size_t capacity);
+
+    // push -----------------------------------------------------------------
+    // waits for room and appends the item; returns false, leaving the item
+    // with the caller, if the queue is closed
+    bool push(T &&);
+
+    // pop ------------------------------------------------------------------
+    // waits for an item and moves the oldest into the parameter; returns
+    // false once the queue is closed and empty
+    bool pop(T &);
+
+    // close ----------------------------------------------------------------
+    // refuses further pushes and wakes every waiting thread
+    void close();
+
+private:
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue& operator=(const BoundedQueue &) = delete;
+
+    mutex lock;                                // guards everything below
+    condition_variable notFull;                // signalled on pop and close
+    condition_variable notEmpty;               // signalled on push and close
+    deque<T> items;                            // oldest first
+    size_t capacity;                           // most items held at once
+    bool closed;                               // true once close is called
+};
+
+
+template <class T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : capacity(capacity > 0 ? capacity : 1), closed(false) {
+}
+
+template <class T>
+bool BoundedQueue<T>::push(T &&item) {
+    unique_lock<mutex> guard(lock);
+    notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+    if (closed) {
+        return false;
+    }
+    items.push_back(std::move(item));
+    guard.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+template <class T>
+bool BoundedQueue<T>::pop(T &item) {
+    unique_lock<mutex> guard(lock);
+    notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+    if (items.empty()) {                       // closed and drained
+        return false;
+    }
+    item = std::move(items.front());
+    items.pop_front();
+    guard.unlock();
+    notFull.notify_one();
+    return true;
+}
+
+template <class T>
+void BoundedQueue<T>::close() {
+    {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+    }
+    notFull.notify_all();
+    notEmpty.notify_all();
+}
+
+#endif
@@ -0,0 +1,827 @@
+//
+//  bplustree.cpp
+//
+//  BPlusTree Object: an ordered set of NodeData with the same interface as
+//  BinTree, stored as a B+-tree sized to the cache line. Each node holds up
+//  to FANOUT keys, and beside every key pointer the first eight bytes of
+//  the key (NodeData::prefix) are kept inline, so the prefixes of one node
+//  fill a single 64-byte line and a node is searched without following any
+//  pointer unless two prefixes tie. Every NodeData lives in a leaf; inner
+//  nodes only route, and the leaves are linked left to right so an inorder
+//  walk never goes back up the tree. Choose it over BinTree through
+//  treeengine.h.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- NodeData::prefix orders keys consistently with operator<, so a
+//        smaller prefix always means a smaller NodeData
+//     -- Arrays given to bstreeToArray must have room for every NodeData of
+//        the tree; the single-argument arrayToBSTree reads 100 slots, and
+//        any index not referencing a NodeData should be NULL
+//     -- getHeight counts levels from the leaves up: 1 for a NodeData found
+//        only in a leaf, higher if it also routes searches in an inner node
+//     -- Two trees are equal if they hold equal NodeData in the same order,
+//        whatever their shape
+//     -- NodeData are never removed one at a time, so inner nodes may point
+//        at NodeData owned by the leaves
+
+#include "bplustree.h"
+#include "outputbuffer.h"
+#include <cstdlib>
+#include <new>
+#include <utility>
+using namespace std;
+
+
+/**
+ * operator<< --------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded operator<< : Prints an inorder traversal of the tree by following the linked leaves
+ * pre: none
+ * post: prints each NodeData in order, separated by spaces, followed by endl
+ */
+
+ostream& operator<<(ostream &out, const BPlusTree &outputTree) {
+    OutputBuffer buffer(out);
+    for (const BPlusTree::Leaf* leaf = outputTree.head; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            leaf->keys[i]->appendTo(buffer);
+            buffer.append(' ');
+        }
+    }
+    buffer.flush();
+    out << endl;
+    return out;
+}
+
+
+// Constructors //////////////////////////////////////////////////////////////
+
+/**
+ * BPlusTree --------------------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates an empty tree
+ */
+
+BPlusTree::BPlusTree() {
+    root = NULL;
+    head = NULL;
+    levels = 0;
+    count = 0;
+}
+
+
+/**
+ * BPlusTree --------------------------------------------------------------------------------------------------------------------------------------
+ * Copy Constructor : copies the NodeData of inputTree leaf by leaf, then builds this tree from them bottom up,
+ * so the copy is linear and its nodes are as full as a bulk load makes them
+ *
+ * @param inputTree : tree to be copied
+ */
+
+BPlusTree::BPlusTree(const BPlusTree &inputTree) {
+    root = NULL;
+    head = NULL;
+    levels = 0;
+    count = 0;
+    vector<NodeData*> copies;
+    copies.reserve(inputTree.count);
+    for (const Leaf* leaf = inputTree.head; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            copies.push_back(new NodeData(*leaf->keys[i]));
+        }
+    }
+    arrayToBSTree(copies.data(), (int)copies.size());
+}
+
+
+/**
+ * ~BPlusTree -------------------------------------------------------------------------------------------------------------------------------------
+ * Destructor : Deallocates all nodes and NodeData
+ */
+
+BPlusTree::~BPlusTree() {
+    makeEmpty();
+}
+
+
+// Assignment Operators //////////////////////////////////////////////////////
+
+/**
+ * operator= ------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded =: deep copies rhsTree into a temporary, then swaps it in
+ *
+ * @param rhsTree : tree to be copied
+ * pre: none
+ * post: this holds copies of the NodeData of rhsTree, and what it held before is deallocated
+ * @return: this reference to new tree
+ */
+
+BPlusTree& BPlusTree::operator=(const BPlusTree &rhsTree) {
+    if (this != &rhsTree) {         // avoid self-assignment by identity
+        BPlusTree copy(rhsTree);
+        swap(copy);                 // old contents released with copy
+    }
+    return *this;
+}
+
+
+/**
+ * swap -----------------------------------------------------------------------------------------------------------------------------------------
+ * swap : exchanges the contents of this tree and otherTree in O(1)
+ */
+
+void BPlusTree::swap(BPlusTree &otherTree) noexcept {
+    std::swap(root, otherTree.root);
+    std::swap(head, otherTree.head);
+    std::swap(levels, otherTree.levels);
+    std::swap(count, otherTree.count);
+}
+
+
+// Equality Operators ////////////////////////////////////////////////////
+
+/**
+ * operator== ------------------------------------------------------------------
+ * overloaded ==: walks the leaves of both trees side by side, comparing prefixes before NodeData
+ *
+ * @param rhsTree : tree to be compared to this
+ * @return: true if both trees hold equal NodeData in the same order
+ */
+
+bool BPlusTree::operator==(const BPlusTree &rhsTree) const {
+    if (count != rhsTree.count) {
+        return false;
+    }
+    const Leaf* lhsLeaf = head;
+    const Leaf* rhsLeaf = rhsTree.head;
+    int lhsIndex = 0;
+    int rhsIndex = 0;
+    for (int n = 0; n < count; n++) {
+        if (lhsIndex == lhsLeaf->count) {       // leaves are never empty
+            lhsLeaf = lhsLeaf->next;
+            lhsIndex = 0;
+        }
+        if (rhsIndex == rhsLeaf->count) {
+            rhsLeaf = rhsLeaf->next;
+            rhsIndex = 0;
+        }
+        if (lhsLeaf->prefixes[lhsIndex] != rhsLeaf->prefixes[rhsIndex]
+            || *lhsLeaf->keys[lhsIndex] != *rhsLeaf->keys[rhsIndex]) {
+            return false;
+        }
+        lhsIndex++;
+        rhsIndex++;
+    }
+    return true;
+}
+
+
+/**
+ * operator!= ------------------------------------------------------------------
+ * overloaded !=: true if the trees differ in any NodeData or in size
+ */
+
+bool BPlusTree::operator!=(const BPlusTree &rhsTree) const {
+    return !(*this == rhsTree);
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * insert -------------------------------------------------------------------
+ * insert : walks down to the leaf for newData, recording the inner nodes passed. If the leaf is full it is split
+ * in two, and the separating key is added to its parent, which may split in turn, up to a new root.
+ *
+ * @param newData : the new newData object to be added to the tree
+ * pre: newData object must be able to be comparable
+ * post: if not a duplicate, newData is owned by the tree
+ * @return: the boolean value of success of insertion; false leaves newData owned by the caller
+ */
+
+bool BPlusTree::insert(NodeData* newData) {
+    unsigned long long want = newData->prefix();
+    if (root == NULL) {
+        head = newLeaf();
+        root = head;
+        levels = 1;
+    }
+    vector<pair<Inner*, int> > path;                // inner nodes and child taken
+    Node* cur = root;
+    while (!cur->leaf) {
+        Inner* inner = static_cast<Inner*>(cur);
+        int index = position(inner, *newData, want, true);
+        path.push_back(make_pair(inner, index));
+        cur = inner->children[index];
+    }
+    Leaf* leaf = static_cast<Leaf*>(cur);
+    int index = position(leaf, *newData, want, false);
+    if (index < leaf->count && *leaf->keys[index] == *newData) {
+        return false;                               // already exists, so skips
+    }
+    count++;
+    if (leaf->count < FANOUT) {
+        insertKey(leaf, index, newData, want);
+        return true;
+    }
+
+    NodeData* separator;
+    unsigned long long separatorPrefix;
+    Node* split = splitLeaf(leaf, index, newData, want, separator, separatorPrefix);
+    while (!path.empty()) {                         // add separator to parents
+        Inner* parent = path.back().first;
+        index = path.back().second;
+        path.pop_back();
+        if (parent->count < FANOUT) {
+            insertKey(parent, index, separator, separatorPrefix);
+            for (int j = parent->count; j > index + 1; j--) {
+                parent->children[j] = parent->children[j - 1];
+            }
+            parent->children[index + 1] = split;
+            return true;
+        }
+        split = splitInner(parent, index, separator, separatorPrefix, split,
+                           separator, separatorPrefix);
+    }
+    Inner* top = newInner();                        // root split, grow a level
+    top->count = 1;
+    top->keys[0] = separator;
+    top->prefixes[0] = separatorPrefix;
+    top->children[0] = root;
+    top->children[1] = split;
+    root = top;
+    levels++;
+    return true;
+}
+
+
+/**
+ * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
+ * makeEmpty : deallocates all nodes and NodeData
+ * pre: none
+ * post: tree is empty
+ */
+
+void BPlusTree::makeEmpty() {
+    releaseNodes(true);
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
+ * to be NodeData object, if found
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree
+ * @return: the boolean value whether object is found
+ */
+
+bool BPlusTree::retrieve(const NodeData &dataDesired, NodeData* &dataRetrieved) const {
+    unsigned long long want = dataDesired.prefix();
+    Leaf* leaf = findLeaf(dataDesired, want);
+    if (leaf != NULL) {
+        int index = position(leaf, dataDesired, want, false);
+        if (index < leaf->count && *leaf->keys[index] == dataDesired) {
+            dataRetrieved = leaf->keys[index];
+            return true;
+        }
+    }
+    dataRetrieved = NULL;                           // NodeData not in tree
+    return false;
+}
+
+
+/**
+ * getHeight ---------------------------------------------------------------------------------------------------------------------------------
+ * getHeight : descends toward dataDesired and returns the level of the first node on the way that holds it, either
+ * as the separator just left of the child taken or as a leaf entry
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @return: the level of the highest node holding the value, 1 if only a leaf, 0 if not found
+ */
+
+int BPlusTree::getHeight(const NodeData &dataDesired) const {
+    unsigned long long want = dataDesired.prefix();
+    const Node* cur = root;
+    int level = levels;
+    while (cur != NULL && !cur->leaf) {
+        const Inner* inner = static_cast<const Inner*>(cur);
+        int index = position(inner, dataDesired, want, true);
+        if (index > 0 && *inner->keys[index - 1] == dataDesired) {
+            return level;                           // separators are leaf keys
+        }
+        cur = inner->children[index];
+        level--;
+    }
+    NodeData* found;
+    return retrieve(dataDesired, found) ? 1 : 0;
+}
+
+
+/**
+ * height / size / isEmpty -------------------------------------------------------------------------------------------------------------------
+ * height : number of levels, 0 if empty. size : number of NodeData. isEmpty : true if there are none
+ */
+
+int BPlusTree::height() const {
+    return levels;
+}
+
+int BPlusTree::size() const {
+    return count;
+}
+
+bool BPlusTree::isEmpty() const {
+    return count == 0;
+}
+
+
+// Using Arrays ////////////////////////////////////////////////////////////////////
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  function to move the NodeData of the tree into an array in order, leaving the tree empty
+ *
+ *  @param newArray : array to be filled with NodeData elements from tree
+ *  pre: newArray must have room for size() elements
+ *  post: tree will be emptied and newArray filled with the tree's own NodeData elements in order
+ */
+
+void BPlusTree::bstreeToArray(NodeData* newArray[]) {
+    bstreeToArray(newArray, count);
+}
+
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  overloaded function to move the NodeData of the tree into a caller-sized array, walking the
+ *  linked leaves. Ownership of each NodeData passes to the caller.
+ *
+ *  @param newArray : array to be filled with NodeData elements from tree
+ *  @param capacity : number of elements newArray has room for
+ *  pre: none
+ *  post: if size() <= capacity, tree is emptied and the first size() elements of newArray hold its NodeData;
+ *  otherwise both are unchanged
+ *  @return: the number of NodeData written to newArray
+ */
+
+int BPlusTree::bstreeToArray(NodeData* newArray[], int capacity) {
+    int written = count;
+    if (written > capacity) {   // does not fit, leave everything alone
+        return 0;
+    }
+    int index = 0;
+    for (const Leaf* leaf = head; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            newArray[index++] = leaf->keys[i];      // hand over, no copy
+        }
+    }
+    releaseNodes(false);        // NodeData now belong to the caller
+    return written;
+}
+
+
+/**
+ *  bstreeToArray  --------------------------------------------------------------------------------------------------------------------------------
+ *  bstreeToArray :  overloaded function to append the NodeData of the tree to a vector in order, leaving the tree
+ *  empty
+ *
+ *  @param newArray : vector the NodeData are appended to
+ */
+
+void BPlusTree::bstreeToArray(vector<NodeData*> &newArray) {
+    size_t start = newArray.size();
+    newArray.resize(start + count);
+    bstreeToArray(newArray.data() + start, count);
+}
+
+
+/**
+*  arraytoBSTree --------------------------------------------------------------------------------------------------------------------------------
+*  arraytoBSTree :  function to build the tree from a sorted 100-element array of NodeData* elements, leaving the
+*  array filled with NULLS
+*
+*  @param oldArray : 100-element NodeData array to be used to build the tree. Elements taken will be replaced with NULL
+*  pre: NodeData array must be a statically-located array of size 100
+*  post: this will be emptied and rebuilt from the elements of oldArray, which will be filled with NULLs
+*/
+
+void BPlusTree::arrayToBSTree(NodeData* oldArray[]) {
+    int high = 0;
+    for (int i = 0; i < 100; i++) {     // count NodeData in array
+        if (oldArray[i] != NULL) {
+            high++;
+        }
+    }
+    arrayToBSTree(oldArray, high);
+}
+
+
+/**
+*  arraytoBSTree --------------------------------------------------------------------------------------------------------------------------------
+*  arraytoBSTree :  overloaded function to build the tree bottom up from the first total elements of a sorted array.
+*  The elements are dealt out evenly to as few leaves as can hold them, the leaves are linked, and then each level
+*  of inner nodes is built over the one below in the same way, until a single root is left. Each separator is the
+*  smallest NodeData under the child to its right.
+*
+*  @param oldArray : sorted NodeData array to be used to build the tree. Elements taken will be replaced with NULL
+*  @param total : number of leading elements of oldArray to use
+*  pre: the first total elements of oldArray are non-NULL, sorted and distinct
+*  post: this will be emptied and rebuilt from the elements of oldArray, which will be filled with NULLs
+*/
+
+void BPlusTree::arrayToBSTree(NodeData* oldArray[], int total) {
+    makeEmpty();
+    if (total <= 0) {
+        return;
+    }
+    vector<Node*> level;                    // current level, left to right
+    vector<NodeData*> lows;                 // smallest NodeData under each
+    int leaves = (total + FANOUT - 1) / FANOUT;
+    int taken = 0;
+    Leaf* previous = NULL;
+    for (int i = 0; i < leaves; i++) {
+        Leaf* leaf = newLeaf();
+        leaf->count = (total - taken) / (leaves - i);
+        for (int j = 0; j < leaf->count; j++) {
+            leaf->keys[j] = oldArray[taken];
+            leaf->prefixes[j] = oldArray[taken]->prefix();
+            oldArray[taken++] = NULL;
+        }
+        if (previous == NULL) {
+            head = leaf;
+        } else {
+            previous->next = leaf;
+        }
+        previous = leaf;
+        level.push_back(leaf);
+        lows.push_back(leaf->keys[0]);
+    }
+    levels = 1;
+
+    while (level.size() > 1) {              // build the next level up
+        vector<Node*> upper;
+        vector<NodeData*> upperLows;
+        int groups = ((int)level.size() + FANOUT) / (FANOUT + 1);
+        int used = 0;
+        for (int g = 0; g < groups; g++) {
+            Inner* inner = newInner();
+            int children = ((int)level.size() - used) / (groups - g);
+            for (int j = 0; j < children; j++) {
+                inner->children[j] = level[used + j];
+                if (j > 0) {
+                    inner->keys[j - 1] = lows[used + j];
+                    inner->prefixes[j - 1] = lows[used + j]->prefix();
+                }
+            }
+            inner->count = children - 1;
+            upper.push_back(inner);
+            upperLows.push_back(lows[used]);
+            used += children;
+        }
+        level.swap(upper);
+        lows.swap(upperLows);
+        levels++;
+    }
+    root = level[0];
+    count = total;
+}
+
+
+/**
+ * displaySideways ------------------------------------------------------------------------------------------------------------------------
+ * Displays the tree as though you are viewing it from the side; hard coded displaying to standard output. Each
+ * leaf is one line of keys, and each separator is printed between the two children it divides.
+ * Preconditions: NONE
+ * Postconditions: tree remains unchanged.
+ */
+
+void BPlusTree::displaySideways() const {
+    displaySideways(cout);
+}
+
+
+/**
+ * displaySideways ------------------------------------------------------------------------------------------------------------------------
+ * overloaded displaySideways : Displays the tree as though you are viewing it from the side, gathering the lines in
+ * an OutputBuffer with no flush per node. A node deeper than maxDepth is shown as one "..." line, as is everything
+ * after maxLines lines; nodes do not know how many keys are below them, so unlike BinTree no count is given.
+ * Preconditions: NONE
+ * Postconditions: tree remains unchanged.
+ * @param out : stream to be written to
+ * @param maxDepth : deepest level shown, the root being level 1; 0 for no limit
+ * @param maxLines : most lines written before the rest is summarized; 0 for no limit
+ */
+
+void BPlusTree::displaySideways(ostream &out, int maxDepth, int maxLines) const {
+    OutputBuffer buffer(out);
+    int lines = 0;
+    sideways(buffer, root, 0, maxDepth, maxLines, lines);
+}
+
+
+/**
+ * Sideways ----------------------------------------------------------------------------------------------------------------------------
+ * Helper method for displaySideways; recursion is bounded by the height, which grows as log base FANOUT
+ * Preconditions: NONE
+ * Postconditions: tree remains unchanged.
+ * @param buffer : where the lines are gathered
+ * @param current : current node to be output
+ * @param level : accounting for space at current depth level
+ * @param maxDepth : deepest level shown; 0 for no limit
+ * @param maxLines : most lines written; 0 for no limit
+ * @param lines : lines written so far, updated
+ * @return: false once the line limit has been reached and the rest summarized
+ */
+
+bool BPlusTree::sideways(OutputBuffer &buffer, const Node* current, int level, int maxDepth, int maxLines,
+                         int &lines) const {
+    if (current == NULL) {
+        return true;
+    }
+    level++;
+    bool cut = maxDepth > 0 && level > maxDepth;
+    if (current->leaf || cut) {
+        buffer.indent(level + 1);               // 4 spaces per depth level
+        if (maxLines > 0 && lines == maxLines) {
+            buffer.append("...\n");
+            return false;
+        }
+        if (cut) {
+            buffer.append("...");
+        }
+        for (int i = 0; !cut && i < current->count; i++) {
+            if (i > 0) {
+                buffer.append(' ');
+            }
+            current->keys[i]->appendTo(buffer);
+        }
+        buffer.append('\n');
+        lines++;
+        return true;
+    }
+    const Inner* inner = static_cast<const Inner*>(current);
+    for (int i = inner->count; i >= 0; i--) {
+        if (!sideways(buffer, inner->children[i], level, maxDepth, maxLines, lines)) {
+            return false;
+        }
+        if (i > 0) {
+            buffer.indent(level + 1);
+            if (maxLines > 0 && lines == maxLines) {
+                buffer.append("...\n");
+                return false;
+            }
+            inner->keys[i - 1]->appendTo(buffer);
+            buffer.append('\n');
+            lines++;
+        }
+    }
+    return true;
+}
+
+
+// Node Helpers ///////////////////////////////////////////////////////////////////
+
+/**
+ * operator new / delete --------------------------------------------------------------------------------------------------------------
+ * operator new : allocates a Leaf or Inner aligned to LINE with posix_memalign, so a node's prefixes never straddle
+ * two cache lines
+ * operator delete : frees memory from operator new
+ *
+ * @param bytes : size of the node being allocated
+ * @return: the aligned memory; throws bad_alloc if there is none
+ */
+
+void* BPlusTree::Node::operator new(size_t bytes) {
+    void* memory = NULL;
+    if (posix_memalign(&memory, LINE, bytes) != 0) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void BPlusTree::Node::operator delete(void* memory) {
+    free(memory);
+}
+
+
+/**
+ * newLeaf / newInner -----------------------------------------------------------------------------------------------------------------
+ * allocate an empty leaf (not yet linked) and an empty inner node
+ */
+
+BPlusTree::Leaf* BPlusTree::newLeaf() {
+    Leaf* leaf = new Leaf();
+    leaf->count = 0;
+    leaf->leaf = true;
+    leaf->next = NULL;
+    return leaf;
+}
+
+BPlusTree::Inner* BPlusTree::newInner() {
+    Inner* inner = new Inner();
+    inner->count = 0;
+    inner->leaf = false;
+    return inner;
+}
+
+
+/**
+ * position ---------------------------------------------------------------------------------------------------------------------------
+ * position : scans the prefixes of cur, which share one cache line, and only compares NodeData on a tie
+ *
+ * @param cur : node to be searched
+ * @param value : value to be placed
+ * @param want : value.prefix()
+ * @param inclusive : true to also count keys equal to value
+ * @return: the number of leading keys less than value (or less than or equal, if inclusive)
+ */
+
+int BPlusTree::position(const Node* cur, const NodeData &value, unsigned long long want,
+                        bool inclusive) {
+    int index = 0;
+    while (index < cur->count) {
+        unsigned long long have = cur->prefixes[index];
+        if (have > want) {
+            break;
+        }
+        if (have == want && (inclusive ? value < *cur->keys[index]
+                                       : !(*cur->keys[index] < value))) {
+            break;
+        }
+        index++;
+    }
+    return index;
+}
+
+
+/**
+ * findLeaf ---------------------------------------------------------------------------------------------------------------------------
+ * findLeaf : descends from the root, taking the child right of every separator not greater than value
+ *
+ * @return: the leaf whose range holds value, or NULL if the tree is empty
+ */
+
+BPlusTree::Leaf* BPlusTree::findLeaf(const NodeData &value, unsigned long long want) const {
+    Node* cur = root;
+    if (cur == NULL) {
+        return NULL;
+    }
+    while (!cur->leaf) {
+        Inner* inner = static_cast<Inner*>(cur);
+        cur = inner->children[position(inner, value, want, true)];
+    }
+    return static_cast<Leaf*>(cur);
+}
+
+
+/**
+ * insertKey --------------------------------------------------------------------------------------------------------------------------
+ * insertKey : places key at position index of cur, shifting later keys right
+ * pre: cur has fewer than FANOUT keys
+ */
+
+void BPlusTree::insertKey(Node* cur, int index, NodeData* key, unsigned long long prefix) {
+    for (int j = cur->count; j > index; j--) {
+        cur->keys[j] = cur->keys[j - 1];
+        cur->prefixes[j] = cur->prefixes[j - 1];
+    }
+    cur->keys[index] = key;
+    cur->prefixes[index] = prefix;
+    cur->count++;
+}
+
+
+/**
+ * splitLeaf --------------------------------------------------------------------------------------------------------------------------
+ * splitLeaf : moves the upper half of a full leaf into a new leaf linked after it, then adds key to whichever half
+ * its position falls in
+ *
+ * @param leaf : full leaf
+ * @param index : position key would take in leaf
+ * @param key / prefix : NodeData being inserted and its prefix
+ * @param separator / separatorPrefix : set to the smallest NodeData of the new leaf
+ * @return: the new leaf
+ */
+
+BPlusTree::Leaf* BPlusTree::splitLeaf(Leaf* leaf, int index, NodeData* key, unsigned long long prefix,
+                                      NodeData* &separator, unsigned long long &separatorPrefix) {
+    Leaf* right = newLeaf();
+    int half = FANOUT / 2;
+    right->count = FANOUT - half;
+    for (int j = 0; j < right->count; j++) {
+        right->keys[j] = leaf->keys[half + j];
+        right->prefixes[j] = leaf->prefixes[half + j];
+    }
+    leaf->count = half;
+    right->next = leaf->next;
+    leaf->next = right;
+    if (index <= half) {
+        insertKey(leaf, index, key, prefix);
+    } else {
+        insertKey(right, index - half, key, prefix);
+    }
+    separator = right->keys[0];
+    separatorPrefix = right->prefixes[0];
+    return right;
+}
+
+
+/**
+ * splitInner -------------------------------------------------------------------------------------------------------------------------
+ * splitInner : lays out the keys and children of a full inner node with the new key and child added, keeps the
+ * lower half, moves the upper half into a new inner node, and passes the middle key up
+ *
+ * @param inner : full inner node
+ * @param index : position key takes in inner; child goes just right of it
+ * @param key / prefix : separator being added and its prefix
+ * @param child : node to the right of key
+ * @param separator / separatorPrefix : set to the middle key, which leaves both halves
+ * @return: the new inner node
+ */
+
+BPlusTree::Inner* BPlusTree::splitInner(Inner* inner, int index, NodeData* key, unsigned long long prefix,
+                                        Node* child, NodeData* &separator,
+                                        unsigned long long &separatorPrefix) {
+    NodeData* keys[FANOUT + 1];
+    unsigned long long prefixes[FANOUT + 1];
+    Node* children[FANOUT + 2];
+    for (int j = 0, from = 0; j <= FANOUT; j++) {
+        if (j == index) {
+            keys[j] = key;
+            prefixes[j] = prefix;
+        } else {
+            keys[j] = inner->keys[from];
+            prefixes[j] = inner->prefixes[from++];
+        }
+    }
+    for (int j = 0, from = 0; j <= FANOUT + 1; j++) {
+        children[j] = (j == index + 1) ? child : inner->children[from++];
+    }
+
+    int middle = (FANOUT + 1) / 2;
+    Inner* right = newInner();
+    inner->count = middle;
+    right->count = FANOUT - middle;
+    for (int j = 0; j < middle; j++) {
+        inner->keys[j] = keys[j];
+        inner->prefixes[j] = prefixes[j];
+    }
+    for (int j = 0; j <= middle; j++) {
+        inner->children[j] = children[j];
+    }
+    for (int j = 0; j < right->count; j++) {
+        right->keys[j] = keys[middle + 1 + j];
+        right->prefixes[j] = prefixes[middle + 1 + j];
+    }
+    for (int j = 0; j <= right->count; j++) {
+        right->children[j] = children[middle + 1 + j];
+    }
+    separator = keys[middle];
+    separatorPrefix = prefixes[middle];
+    return right;
+}
+
+
+/**
+ * releaseNodes -----------------------------------------------------------------------------------------------------------------------
+ * releaseNodes : deallocates every node with an explicit stack. Separators point at NodeData owned by the leaves,
+ * so NodeData are only deleted from leaves.
+ *
+ * @param deleteData : true to delete the NodeData too, false if they were handed to someone else
+ * post: tree is empty
+ */
+
+void BPlusTree::releaseNodes(bool deleteData) {
+    vector<Node*> pending;
+    if (root != NULL) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        Node* cur = pending.back();
+        pending.pop_back();
+        if (cur->leaf) {
+            if (deleteData) {
+                for (int i = 0; i < cur->count; i++) {
+                    delete cur->keys[i];
+                }
+            }
+            delete static_cast<Leaf*>(cur);
+        } else {
+            Inner* inner = static_cast<Inner*>(cur);
+            for (int i = 0; i <= inner->count; i++) {
+                pending.push_back(inner->children[i]);
+            }
+            delete inner;
+        }
+    }
+    root = NULL;
+    head = NULL;
+    levels = 0;
+    count = 0;
+}
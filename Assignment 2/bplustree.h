@@ -0,0 +1,235 @@
+//
+//  bplustree.h
+//
+//  BPlusTree Object: an ordered set of NodeData with the same interface as
+//  BinTree, stored as a B+-tree sized to the cache line. Each node holds up
+//  to FANOUT keys, and beside every key pointer the first eight bytes of
+//  the key (NodeData::prefix) are kept inline, so the prefixes of one node
+//  fill a single 64-byte line and a node is searched without following any
+//  pointer unless two prefixes tie. Every NodeData lives in a leaf; inner
+//  nodes only route, and the leaves are linked left to right so an inorder
+//  walk never goes back up the tree. Choose it over BinTree through
+//  treeengine.h.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- NodeData::prefix orders keys consistently with operator<, so a
+//        smaller prefix always means a smaller NodeData
+//     -- Arrays given to bstreeToArray must have room for every NodeData of
+//        the tree; the single-argument arrayToBSTree reads 100 slots, and
+//        any index not referencing a NodeData should be NULL
+//     -- getHeight counts levels from the leaves up: 1 for a NodeData found
+//        only in a leaf, higher if it also routes searches in an inner node
+//     -- Two trees are equal if they hold equal NodeData in the same order,
+//        whatever their shape
+//     -- NodeData are never removed one at a time, so inner nodes may point
+//        at NodeData owned by the leaves
+
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+#include <cstddef>
+#include <vector>
+#include "nodedata.h"
+using namespace std;
+
+class OutputBuffer;
+
+class BPlusTree {
+
+    // operator<< -------------------------------------------------------
+    // Prints an inorder traversal of the tree to out, followed by endl
+    friend ostream& operator<<(ostream &out, const BPlusTree &);
+
+public:
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // BPlusTree ----------------------------------------------------------
+    // Default Constructor : creates an empty tree
+    BPlusTree();
+
+    // BPlusTree ----------------------------------------------------------
+    // Copy Constructor : creates a deep copy of the inputTree
+    BPlusTree(const BPlusTree &);
+
+    // ~BPlusTree ---------------------------------------------------------
+    // Destructor : Deallocates all nodes and NodeData
+    ~BPlusTree();
+
+
+    // Assignment Operators ////////////////////////////////////////////////
+
+    // operator= --------------------------------------------------------
+    // overloaded =: deep copies the parameter tree into this
+    BPlusTree& operator=(const BPlusTree &);
+
+    // swap -------------------------------------------------------------
+    // exchanges the contents of this tree and the parameter in O(1)
+    void swap(BPlusTree &) noexcept;
+
+
+    // Equality Operators //////////////////////////////////////////////////
+
+    // operator== / operator!= -------------------------------------------
+    // true if both trees hold equal NodeData in the same order
+    bool operator==(const BPlusTree &) const;
+    bool operator!=(const BPlusTree &) const;
+
+
+    // Mutators ////////////////////////////////////////////////////////////
+
+    // insert ---------------------------------------------------------------
+    // inserts the input newData into its leaf, splitting full nodes on the
+    // way back up. Returns false for a duplicate, which the caller deletes
+    bool insert(NodeData*);
+
+    // makeEmpty ------------------------------------------------------------
+    // deallocates all nodes and NodeData
+    void makeEmpty();
+
+
+    // Accessors ///////////////////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether data desired is in this tree,
+    // modifying the dataRetrieved directly to be NodeData object, if found
+    bool retrieve(const NodeData &, NodeData* &) const;
+
+    // getHeight ------------------------------------------------------------
+    // returns the level of the highest node holding the given value, 1 for
+    // a leaf and 0 if the value is not found
+    int getHeight(const NodeData &) const;
+
+    // height / size / isEmpty ----------------------------------------------
+    // number of levels, number of NodeData, and whether there are none
+    int height() const;
+    int size() const;
+    bool isEmpty() const;
+
+
+    // Output Functions /////////////////////////////////////////////////////
+
+    // displaySideways -----------------------------------------------------
+    // Displays the tree as though you are viewing it from the side, one
+    // node per line with its keys; hard coded displaying to standard output.
+    void displaySideways() const;
+
+    // displaySideways -----------------------------------------------------
+    // overloaded displaySideways writes to the given stream. Nodes below
+    // maxDepth levels, and everything after maxLines lines, are each shown
+    // as one "..." line; 0 means no limit
+    void displaySideways(ostream &, int maxDepth = 0, int maxLines = 0) const;
+
+    // bstreeToArray  -------------------------------------------------------
+    // hands the NodeData over to an array in order, leaving the tree empty.
+    // The array must have room for size() elements
+    void bstreeToArray(NodeData* []);
+
+    // bstreeToArray  -------------------------------------------------------
+    // overloaded bstreeToArray for an array of the given capacity; returns
+    // how many were written, or 0 with the tree unchanged if it does not fit
+    int bstreeToArray(NodeData* [], int);
+
+    // bstreeToArray  -------------------------------------------------------
+    // overloaded bstreeToArray appends the NodeData to a vector in order
+    void bstreeToArray(vector<NodeData*> &);
+
+    // arraytoBSTree -----------------------------------------------------
+    // builds the tree from a sorted 100-element array of NodeData*, leaving
+    // the array filled with NULLS
+    void arrayToBSTree(NodeData* []);
+
+    // arraytoBSTree -----------------------------------------------------
+    // overloaded arrayToBSTree builds the tree bottom up from the first
+    // count elements of a sorted array in linear time, leaving them NULL
+    void arrayToBSTree(NodeData* [], int);
+
+private:
+
+    // keys per node; their prefixes fill one 64-byte cache line
+    static const int FANOUT = 8;
+
+    // bytes in a cache line, the alignment of every node
+    static const size_t LINE = 64;
+
+    // Fields shared by leaves and inner nodes. Nodes start on a cache line,
+    // and prefixes come first, so they occupy exactly that line
+    struct alignas(LINE) Node {
+        unsigned long long prefixes[FANOUT];   // NodeData::prefix of each key
+        NodeData* keys[FANOUT];                // items, or separators
+        int count;                             // keys in use
+        bool leaf;                             // true if a Leaf
+
+        // operator new / delete ----------------------------------------
+        // allocate on a cache line boundary, which plain new does not do
+        // for over-aligned types before C++17
+        static void* operator new(size_t);
+        static void operator delete(void*);
+    };
+
+    // Holds NodeData; keys[i] is owned by the tree
+    struct Leaf : Node {
+        Leaf* next;                            // leaf to the right, or NULL
+    };
+
+    // Routes searches; keys[i] is the smallest NodeData below children[i + 1]
+    struct Inner : Node {
+        Node* children[FANOUT + 1];            // count + 1 subtrees
+    };
+
+    Node* root;                                // root of the tree, or NULL
+    Leaf* head;                                // leftmost leaf, or NULL
+    int levels;                                // height of the tree
+    int count;                                 // NodeData in the tree
+
+
+    // Utility functions //////////////////////////////////////////////
+
+    // newLeaf / newInner -------------------------------------------------
+    // allocate an empty node of each kind
+    static Leaf* newLeaf();
+    static Inner* newInner();
+
+    // position -------------------------------------------------------------
+    // number of leading keys of the node less than the given value (with
+    // the given prefix), or less than or equal to it if inclusive is true
+    static int position(const Node*, const NodeData &, unsigned long long, bool);
+
+    // findLeaf -------------------------------------------------------------
+    // descends to the leaf whose range holds the given value
+    Leaf* findLeaf(const NodeData &, unsigned long long) const;
+
+    // insertKey ------------------------------------------------------------
+    // shifts the keys of a node with room right and places a key at the
+    // given index
+    static void insertKey(Node*, int, NodeData*, unsigned long long);
+
+    // splitLeaf / splitInner -----------------------------------------------
+    // split a full node while adding one key (and, for an inner node, the
+    // child to its right). Return the new right node and report the key
+    // that separates the two halves
+    Leaf* splitLeaf(Leaf*, int, NodeData*, unsigned long long,
+                    NodeData* &, unsigned long long &);
+    Inner* splitInner(Inner*, int, NodeData*, unsigned long long, Node*,
+                      NodeData* &, unsigned long long &);
+
+    // releaseNodes ---------------------------------------------------------
+    // iteratively deallocates every node, deleting the NodeData in the
+    // leaves if deleteData is true
+    void releaseNodes(bool);
+
+    // sideways -------------------------------------------------------------
+    // Helper method for displaySideways; returns false once maxLines lines
+    // have been written and the rest summarized
+    bool sideways(OutputBuffer &, const Node*, int, int, int, int &) const;
+};
+
+
+// swap -----------------------------------------------------------------------
+// non-member swap so std algorithms and containers find it by lookup
+
+inline void swap(BPlusTree &lhs, BPlusTree &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+#endif
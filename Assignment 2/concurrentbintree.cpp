@@ -0,0 +1,501 @@
+//
+//  concurrentbintree.cpp
+//
+//  ConcurrentBinTree Object: a self-balancing binary search tree of NodeData
+//  that many threads may read while one thread at a time writes. Readers
+//  never take a lock: every Node is immutable once published, and a writer
+//  builds a new root-to-leaf path (copying only the Nodes it changes) and
+//  then publishes the new root with a single atomic store. Nodes replaced by
+//  a writer are reclaimed only after every reader that could still see them
+//  has finished, using epoch-based reclamation.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- Writers (insert, makeEmpty) are serialized by a mutex internal to
+//        the tree; readers (retrieve, getHeight, height, size, isEmpty,
+//        forEach, operator<<) run concurrently with them and each other
+//     -- A NodeData* returned by retrieve may only be used while no
+//        makeEmpty can run; readers that overlap makeEmpty use the copying
+//        retrieve, which reads the NodeData before its guard ends
+//     -- The tree must not be destroyed while any thread is still reading it
+
+#include "concurrentbintree.h"
+#include <algorithm>
+using namespace std;
+
+
+// Epochs //////////////////////////////////////////////////////////////////////
+//
+// One global epoch counter is shared by every ConcurrentBinTree. Each thread
+// that reads owns a slot recording the epoch it entered in, or 0 while it is
+// not reading. The epoch may only advance once every reading thread has
+// entered in the current epoch, so anything unlinked in epoch e can no longer
+// be reached by any reader once the global epoch reaches e + 2.
+
+namespace {
+
+struct ReaderSlot {
+    atomic<unsigned long> epoch;               // entry epoch, 0 when idle
+    atomic<bool> inUse;                        // owned by a live thread
+    ReaderSlot* next;                          // next slot in registry
+};
+
+atomic<unsigned long> globalEpoch(1);
+atomic<ReaderSlot*> slotList(NULL);            // slots are never freed
+
+// acquireSlot: reuses a slot left by an exited thread, or adds a new one
+ReaderSlot* acquireSlot() {
+    for (ReaderSlot* slot = slotList.load(); slot != NULL; slot = slot->next) {
+        bool expected = false;
+        if (slot->inUse.compare_exchange_strong(expected, true)) {
+            return slot;
+        }
+    }
+    ReaderSlot* slot = new ReaderSlot();
+    slot->epoch.store(0);
+    slot->inUse.store(true);
+    slot->next = slotList.load();
+    while (!slotList.compare_exchange_weak(slot->next, slot)) {
+    }
+    return slot;
+}
+
+// Per-thread reading state, handing its slot back when the thread exits
+struct ThreadRecord {
+    ReaderSlot* slot;
+    int depth;                                 // nested ReadGuards
+
+    ThreadRecord() : slot(acquireSlot()), depth(0) { }
+    ~ThreadRecord() {
+        slot->epoch.store(0);
+        slot->inUse.store(false);
+    }
+};
+
+thread_local ThreadRecord threadRecord;
+
+// tryAdvance: moves the global epoch forward if every reader has caught up
+void tryAdvance() {
+    unsigned long current = globalEpoch.load();
+    for (ReaderSlot* slot = slotList.load(); slot != NULL; slot = slot->next) {
+        unsigned long seen = slot->epoch.load();
+        if (seen != 0 && seen != current) {    // a reader is behind
+            return;
+        }
+    }
+    globalEpoch.compare_exchange_strong(current, current + 1);
+}
+
+}
+
+
+/**
+ * ReadGuard --------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : records the current epoch in this thread's slot before anything is read. Publishing it with a
+ * seq_cst exchange keeps the loads of root that follow from being performed before the slot is visible to writers.
+ */
+
+ConcurrentBinTree::ReadGuard::ReadGuard() {
+    ThreadRecord &record = threadRecord;
+    if (record.depth++ == 0) {
+        record.slot->epoch.exchange(globalEpoch.load(), memory_order_seq_cst);
+    }
+}
+
+
+/**
+ * ~ReadGuard -------------------------------------------------------------------------------------------------------------------------------
+ * Destructor : marks this thread as no longer reading once the outermost guard ends
+ */
+
+ConcurrentBinTree::ReadGuard::~ReadGuard() {
+    ThreadRecord &record = threadRecord;
+    if (--record.depth == 0) {
+        record.slot->epoch.store(0, memory_order_release);
+    }
+}
+
+
+/**
+ * operator<< --------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded operator<< : Prints an inorder traversal of the tree
+ * pre: none
+ * post: prints one consistent version of the tree as an inorder traversal to out
+ */
+
+ostream& operator<<(ostream &out, const ConcurrentBinTree &outputTree) {
+    outputTree.forEach([&out](const NodeData &data) { out << data << " "; });
+    out << endl;
+    return out;
+}
+
+
+// Constructors //////////////////////////////////////////////////////////////
+
+/**
+ * ConcurrentBinTree ------------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates an empty tree
+ */
+
+ConcurrentBinTree::ConcurrentBinTree() : root(NULL) {
+}
+
+
+/**
+ * ~ConcurrentBinTree -----------------------------------------------------------------------------------------------------------------------------
+ * Destructor : Deallocates the current version and everything still waiting to be reclaimed
+ * pre: no thread is reading this tree
+ */
+
+ConcurrentBinTree::~ConcurrentBinTree() {
+    deleteTree(root.load());
+    while (!retired.empty()) {
+        if (retired.front().wholeTree) {
+            deleteTree(retired.front().node);
+        } else {
+            delete retired.front().node;
+        }
+        retired.pop_front();
+    }
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * insert -------------------------------------------------------------------
+ * insert : inserts a new Node containing newData. The new version shares every subtree the insert did not touch
+ * with the old one and is published with one release store, so readers see either version but never a mix.
+ *
+ * @param newData : the new newData object to be added to the tree
+ * pre: newData object must be able to be comparable
+ * post: the published tree contains newData, stays AVL balanced, and the replaced path Nodes are retired
+ * @return: the boolean value of success of insertion; false leaves newData owned by the caller
+ */
+
+bool ConcurrentBinTree::insert(NodeData* newData) {
+    lock_guard<mutex> lock(writeLock);
+    vector<Node*> discarded;
+    bool inserted = false;
+    Node* updated = insertHelper(root.load(memory_order_relaxed), newData,
+                                 inserted, discarded);
+    if (!inserted) {
+        return false;
+    }
+    root.store(updated, memory_order_release);  // publish new version
+    for (size_t i = 0; i < discarded.size(); i++) {
+        retire(discarded[i], false);
+    }
+    reclaim();
+    return true;
+}
+
+
+/**
+ * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
+ * makeEmpty : publishes an empty tree and retires the old version as a whole
+ * pre: none
+ * post: the published tree is empty; old Nodes and NodeData are freed once no reader can reach them
+ */
+
+void ConcurrentBinTree::makeEmpty() {
+    lock_guard<mutex> lock(writeLock);
+    Node* old = root.exchange(NULL, memory_order_acq_rel);
+    if (old != NULL) {
+        retire(old, true);
+    }
+    reclaim();
+}
+
+
+/**
+ * retiredCount ---------------------------------------------------------------------------------------------------------------------------
+ * retiredCount : reports how much reclamation is still pending, taking the writer lock to read the retired queue
+ * pre: none
+ * post: tree is unchanged
+ * @return: the number of retired entries not yet deallocated
+ */
+
+int ConcurrentBinTree::retiredCount() {
+    lock_guard<mutex> lock(writeLock);
+    return (int)retired.size();
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
+ * to be NodeData object, if found. Takes no lock.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree, valid until a makeEmpty can run
+ * @return: the boolean value whether object is found
+ */
+
+bool ConcurrentBinTree::retrieve(const NodeData &dataDesired, const NodeData* &dataRetrieved) const {
+    ReadGuard guard;
+    Node* found = findNode(root.load(memory_order_acquire), dataDesired);
+    dataRetrieved = (found == NULL) ? NULL : found->data;
+    return found != NULL;
+}
+
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded retrieve : copies the NodeData equal to dataDesired into dataRetrieved while the guard still keeps it
+ * from being reclaimed, so it is safe to use alongside makeEmpty. Takes no lock.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : set to a copy of the object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved equals the object in tree; otherwise dataRetrieved is unchanged
+ * @return: the boolean value whether object is found
+ */
+
+bool ConcurrentBinTree::retrieve(const NodeData &dataDesired, NodeData &dataRetrieved) const {
+    ReadGuard guard;
+    Node* found = findNode(root.load(memory_order_acquire), dataDesired);
+    if (found == NULL) {
+        return false;
+    }
+    dataRetrieved = *found->data;
+    return true;
+}
+
+
+/**
+ * getHeight ---------------------------------------------------------------------------------------------------------------------------------
+ * getHeight : returns the cached height of the Node holding dataDesired. Takes no lock.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * pre: none
+ * post: tree is unchanged
+ * @return: the height of the tree at the given node, 1 if leaf, 0 if not found
+ */
+
+int ConcurrentBinTree::getHeight(const NodeData &dataDesired) const {
+    ReadGuard guard;
+    return nodeHeight(findNode(root.load(memory_order_acquire), dataDesired));
+}
+
+
+/**
+ * height / size / isEmpty -------------------------------------------------------------------------------------------------------------------
+ * read from the root of the current version; the root's own fields are immutable once published
+ */
+
+int ConcurrentBinTree::height() const {
+    ReadGuard guard;
+    return nodeHeight(root.load(memory_order_acquire));
+}
+
+int ConcurrentBinTree::size() const {
+    ReadGuard guard;
+    return nodeSize(root.load(memory_order_acquire));
+}
+
+bool ConcurrentBinTree::isEmpty() const {
+    return root.load(memory_order_acquire) == NULL;
+}
+
+
+// Utility functions ///////////////////////////////////////////////////////////
+
+/**
+ * makeNode ---------------------------------------------------------------------
+ * makeNode : allocates a Node holding data with the given children, computing its height and size
+ */
+
+ConcurrentBinTree::Node* ConcurrentBinTree::makeNode(NodeData* data, Node* left, Node* right) {
+    Node* fresh = new Node();
+    fresh->data = data;
+    fresh->left = left;
+    fresh->right = right;
+    fresh->height = 1 + max(nodeHeight(left), nodeHeight(right));
+    fresh->size = 1 + nodeSize(left) + nodeSize(right);
+    return fresh;
+}
+
+
+/**
+ * nodeHeight / nodeSize ---------------------------------------------------------
+ * cached height and size of cur, 0 if NULL
+ */
+
+int ConcurrentBinTree::nodeHeight(Node* cur) {
+    return (cur == NULL) ? 0 : cur->height;
+}
+
+int ConcurrentBinTree::nodeSize(Node* cur) {
+    return (cur == NULL) ? 0 : cur->size;
+}
+
+
+/**
+ * balance -----------------------------------------------------------------------
+ * balance : builds a Node from data, left and right, performing the single or double rotation the AVL property
+ * needs. Rotations build new Nodes rather than relinking old ones, since old Nodes may still be read.
+ *
+ * @param data : NodeData of the subtree root before rotating
+ * @param left : left subtree
+ * @param right : right subtree
+ * @param discarded : receives every existing Node a rotation replaces
+ * pre: left and right are AVL balanced and differ in height by at most two
+ * post: none of the given Nodes are modified
+ * @return: root of an AVL balanced subtree holding the same NodeData
+ */
+
+ConcurrentBinTree::Node* ConcurrentBinTree::balance(NodeData* data, Node* left, Node* right,
+                                                    vector<Node*> &discarded) {
+    if (nodeHeight(left) > nodeHeight(right) + 1) {             // left heavy
+        if (nodeHeight(left->left) >= nodeHeight(left->right)) { // single
+            discarded.push_back(left);
+            return makeNode(left->data, left->left,
+                            makeNode(data, left->right, right));
+        }
+        Node* pivot = left->right;                              // double
+        discarded.push_back(left);
+        discarded.push_back(pivot);
+        return makeNode(pivot->data, makeNode(left->data, left->left, pivot->left),
+                        makeNode(data, pivot->right, right));
+    }
+    if (nodeHeight(right) > nodeHeight(left) + 1) {             // right heavy
+        if (nodeHeight(right->right) >= nodeHeight(right->left)) {
+            discarded.push_back(right);
+            return makeNode(right->data, makeNode(data, left, right->left),
+                            right->right);
+        }
+        Node* pivot = right->left;
+        discarded.push_back(right);
+        discarded.push_back(pivot);
+        return makeNode(pivot->data, makeNode(data, left, pivot->left),
+                        makeNode(right->data, pivot->right, right->right));
+    }
+    return makeNode(data, left, right);
+}
+
+
+/**
+ * insertHelper ------------------------------------------------------------------
+ * insertHelper : returns a new version of the subtree at cur with newData added. Only the Nodes on the path to
+ * the insertion point are copied; the recursion depth is the height of an AVL tree, so it is O(log n).
+ *
+ * @param cur : root of the current version of the subtree
+ * @param newData : the new newData object to be added to the tree
+ * @param inserted : set to true if newData was added, false if it was a duplicate
+ * @param discarded : receives every Node of the old version that the new version replaces
+ * pre: newData object must be able to be comparable
+ * post: the old version is unchanged
+ * @return: root of the new version, or cur itself if newData was a duplicate
+ */
+
+ConcurrentBinTree::Node* ConcurrentBinTree::insertHelper(Node* cur, NodeData* newData, bool &inserted,
+                                                         vector<Node*> &discarded) {
+    if (cur == NULL) {                              // base case to create new Node
+        inserted = true;
+        return makeNode(newData, NULL, NULL);
+    }
+    int order = newData->compare(*cur->data);
+    if (order < 0) {                                // BST, smaller goes left
+        Node* left = insertHelper(cur->left, newData, inserted, discarded);
+        if (!inserted) {
+            return cur;
+        }
+        discarded.push_back(cur);
+        return balance(cur->data, left, cur->right, discarded);
+    }
+    if (order > 0) {                                // BST, larger goes right
+        Node* right = insertHelper(cur->right, newData, inserted, discarded);
+        if (!inserted) {
+            return cur;
+        }
+        discarded.push_back(cur);
+        return balance(cur->data, cur->left, right, discarded);
+    }
+    inserted = false;                               // already exists, so skips
+    return cur;
+}
+
+
+/**
+ * findNode ----------------------------------------------------------------------
+ * findNode : descends from cur by the BST ordering to the Node holding dataDesired
+ *
+ * @return: the Node holding dataDesired, or NULL if it is not in the subtree
+ */
+
+ConcurrentBinTree::Node* ConcurrentBinTree::findNode(Node* cur, const NodeData &dataDesired) {
+    int order = 0;
+    while (cur != NULL && (order = dataDesired.compare(*cur->data)) != 0) {
+        cur = (order < 0) ? cur->left : cur->right;
+    }
+    return cur;
+}
+
+
+/**
+ * deleteTree --------------------------------------------------------------------
+ * deleteTree : deallocates every Node and NodeData of the subtree at cur, using an explicit stack
+ */
+
+void ConcurrentBinTree::deleteTree(Node* cur) {
+    vector<Node*> pending;
+    if (cur != NULL) {
+        pending.push_back(cur);
+    }
+    while (!pending.empty()) {
+        cur = pending.back();
+        pending.pop_back();
+        if (cur->left != NULL) {
+            pending.push_back(cur->left);
+        }
+        if (cur->right != NULL) {
+            pending.push_back(cur->right);
+        }
+        delete cur->data;
+        delete cur;
+    }
+}
+
+
+/**
+ * retire ------------------------------------------------------------------------
+ * retire : queues a Node that is no longer reachable from root, stamped with the current epoch
+ *
+ * @param cur : unlinked Node
+ * @param wholeTree : true to also free cur's subtrees and NodeData, false for the Node alone
+ * pre: called by the writer holding writeLock
+ */
+
+void ConcurrentBinTree::retire(Node* cur, bool wholeTree) {
+    Retired entry;
+    entry.node = cur;
+    entry.wholeTree = wholeTree;
+    entry.epoch = globalEpoch.load();
+    retired.push_back(entry);
+}
+
+
+/**
+ * reclaim -----------------------------------------------------------------------
+ * reclaim : tries to advance the global epoch, then frees every retired entry at least two epochs old
+ * pre: called by the writer holding writeLock
+ */
+
+void ConcurrentBinTree::reclaim() {
+    tryAdvance();
+    unsigned long current = globalEpoch.load();
+    while (!retired.empty() && retired.front().epoch + 2 <= current) {
+        if (retired.front().wholeTree) {
+            deleteTree(retired.front().node);
+        } else {
+            delete retired.front().node;
+        }
+        retired.pop_front();
+    }
+}
@@ -0,0 +1,194 @@
+//
+//  concurrentbintree.h
+//
+//  ConcurrentBinTree Object: a self-balancing binary search tree of NodeData
+//  that many threads may read while one thread at a time writes. Readers
+//  never take a lock: every Node is immutable once published, and a writer
+//  builds a new root-to-leaf path (copying only the Nodes it changes) and
+//  then publishes the new root with a single atomic store. Nodes replaced by
+//  a writer are reclaimed only after every reader that could still see them
+//  has finished, using epoch-based reclamation.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- Writers (insert, makeEmpty) are serialized by a mutex internal to
+//        the tree; readers (retrieve, getHeight, height, size, isEmpty,
+//        forEach, operator<<) run concurrently with them and each other
+//     -- A NodeData* returned by retrieve may only be used while no
+//        makeEmpty can run; readers that overlap makeEmpty use the copying
+//        retrieve, which reads the NodeData before its guard ends
+//     -- The tree must not be destroyed while any thread is still reading it
+
+#ifndef CONCURRENTBINTREE_H
+#define CONCURRENTBINTREE_H
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "nodedata.h"
+using namespace std;
+
+class ConcurrentBinTree {
+
+    // operator<< -------------------------------------------------------
+    // Prints an inorder traversal of one consistent version of the tree
+    friend ostream& operator<<(ostream &out, const ConcurrentBinTree &);
+
+public:
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // ConcurrentBinTree -------------------------------------------------
+    // Default Constructor : creates an empty tree
+    ConcurrentBinTree();
+
+    // ~ConcurrentBinTree ------------------------------------------------
+    // Destructor : Deallocates all nodes, NodeData and retired nodes
+    ~ConcurrentBinTree();
+
+
+    // Mutators (one writer at a time) /////////////////////////////////////
+
+    // insert ---------------------------------------------------------------
+    // inserts a new Node containing the input newData and publishes the new
+    // version of the tree. Returns false for a duplicate, in which case the
+    // caller still owns newData
+    bool insert(NodeData*);
+
+    // makeEmpty ------------------------------------------------------------
+    // publishes an empty tree; the old Nodes and NodeData are deallocated
+    // once no reader can still be using them
+    void makeEmpty();
+
+    // retiredCount ---------------------------------------------------------
+    // number of unlinked Nodes and trees still waiting to be deallocated;
+    // it falls back to zero within a few writes once no reader is active
+    int retiredCount();
+
+
+    // Accessors (lock-free) ///////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether data desired is in this tree,
+    // modifying the dataRetrieved directly to be NodeData object, if found.
+    // The NodeData is shared with every reader, so it is read-only
+    bool retrieve(const NodeData &, const NodeData* &) const;
+
+    // overloaded retrieve copies the NodeData found into dataRetrieved,
+    // so the result stays usable whatever writers do afterwards
+    bool retrieve(const NodeData &, NodeData &) const;
+
+    // getHeight ------------------------------------------------------------
+    // returns the height of the subtree holding the given value, 1 for a
+    // leaf and 0 if the value is not found
+    int getHeight(const NodeData &) const;
+
+    // height / size / isEmpty ----------------------------------------------
+    // height and Node count of the whole tree, and whether it has no Nodes
+    int height() const;
+    int size() const;
+    bool isEmpty() const;
+
+    // forEach --------------------------------------------------------------
+    // calls visit(const NodeData &) on every NodeData in order, all taken
+    // from the same version of the tree even while a writer is inserting
+    template <class Visitor>
+    void forEach(Visitor) const;
+
+private:
+    ConcurrentBinTree(const ConcurrentBinTree &) = delete;
+    ConcurrentBinTree& operator=(const ConcurrentBinTree &) = delete;
+
+    // Immutable once reachable from root
+    struct Node {
+        NodeData* data;                        // pointer to data object
+        Node* left;                            // left subtree pointer
+        Node* right;                           // right subtree pointer
+        int height;                            // height of subtree, leaf is 1
+        int size;                              // number of Nodes in subtree
+    };
+
+    // Marks the calling thread as reading for as long as the guard lives,
+    // so nothing it can reach is reclaimed underneath it. Guards may nest.
+    class ReadGuard {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+    };
+
+    // A Node unlinked by a writer, waiting for its epoch to pass
+    struct Retired {
+        Node* node;                            // Node no longer reachable
+        bool wholeTree;                        // also free subtree and data
+        unsigned long epoch;                   // epoch when unlinked
+    };
+
+    atomic<Node*> root;                        // current published version
+    mutex writeLock;                           // serializes writers
+    deque<Retired> retired;                    // oldest first, writer only
+
+
+    // Utility functions //////////////////////////////////////////////
+
+    // makeNode -------------------------------------------------------------
+    // allocates a Node with the given data and children, computing its
+    // height and size
+    static Node* makeNode(NodeData*, Node*, Node*);
+
+    // nodeHeight / nodeSize -----------------------------------------------
+    // cached height and size of a Node, 0 if NULL
+    static int nodeHeight(Node*);
+    static int nodeSize(Node*);
+
+    // balance --------------------------------------------------------------
+    // builds a Node from data and two AVL subtrees whose heights differ by
+    // at most two, rotating if needed. Existing Nodes that a rotation
+    // replaces are added to the discarded list
+    static Node* balance(NodeData*, Node*, Node*, vector<Node*> &);
+
+    // insertHelper ---------------------------------------------------------
+    // returns the root of a new version of the subtree with newData added,
+    // sharing every untouched subtree with the old version. Replaced Nodes
+    // are added to the discarded list
+    static Node* insertHelper(Node*, NodeData*, bool &, vector<Node*> &);
+
+    // findNode -------------------------------------------------------------
+    // descends from the given root to the Node holding the value, or NULL
+    static Node* findNode(Node*, const NodeData &);
+
+    // deleteTree -----------------------------------------------------------
+    // iteratively deallocates every Node and NodeData of a subtree
+    static void deleteTree(Node*);
+
+    // retire ---------------------------------------------------------------
+    // queues an unlinked Node (or whole subtree) for reclamation
+    void retire(Node*, bool);
+
+    // reclaim --------------------------------------------------------------
+    // tries to advance the global epoch, then deallocates everything retired
+    // at least two epochs ago
+    void reclaim();
+};
+
+
+// forEach --------------------------------------------------------------------
+// Walks the version published when the call began with an explicit stack.
+
+template <class Visitor>
+void ConcurrentBinTree::forEach(Visitor visit) const {
+    ReadGuard guard;
+    vector<Node*> pending;
+    Node* cur = root.load(memory_order_acquire);
+    while (cur != NULL || !pending.empty()) {
+        while (cur != NULL) {
+            pending.push_back(cur);
+            cur = cur->left;
+        }
+        cur = pending.back();
+        pending.pop_back();
+        visit(*cur->data);
+        cur = cur->right;
+    }
+}
+
+#endif
@@ -0,0 +1,303 @@
+//
+//  frozenbintree.cpp
+//
+//  FrozenBinTree Object: a read-only search index over the NodeData of a
+//  finished BinTree. Freezing takes the tree's NodeData in order (through
+//  bstreeToArray) and lays them out in one contiguous array in Eytzinger
+//  order: the root at index 1 and the children of index k at 2k and 2k + 1,
+//  so no child pointers are stored. Beside each NodeData* the first eight
+//  bytes of its key are kept inline, and lower_bound descends on those
+//  alone, without branches, prefetching the levels ahead of it. A NodeData
+//  is only dereferenced when two keys share the same eight-byte prefix.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- NodeData::prefix orders keys consistently with operator<, so a
+//        smaller prefix always means a smaller NodeData
+//     -- A frozen tree is never modified; freezing again replaces it whole
+//     -- A NodeData* returned by retrieve or lower_bound stays valid until
+//        the tree is frozen again or destroyed
+
+#include "frozenbintree.h"
+using namespace std;
+
+
+/**
+ * operator<< --------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded operator<< : Prints an inorder traversal of the tree
+ * pre: none
+ * post: prints each NodeData in order, separated by spaces, followed by endl
+ */
+
+ostream& operator<<(ostream &out, const FrozenBinTree &outputTree) {
+    for (size_t k = outputTree.firstIndex(); k != 0; k = outputTree.nextIndex(k)) {
+        out << *outputTree.items[k] << " ";
+    }
+    out << endl;
+    return out;
+}
+
+
+// Constructors //////////////////////////////////////////////////////////////
+
+/**
+ * FrozenBinTree ----------------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates an empty index
+ */
+
+FrozenBinTree::FrozenBinTree() {
+}
+
+
+/**
+ * FrozenBinTree ----------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : creates an index holding every NodeData of sourceTree
+ *
+ * @param sourceTree : BinTree to be frozen; left empty
+ */
+
+FrozenBinTree::FrozenBinTree(BinTree &sourceTree) {
+    freeze(sourceTree);
+}
+
+
+/**
+ * ~FrozenBinTree ---------------------------------------------------------------------------------------------------------------------------------
+ * Destructor : Deallocates all NodeData
+ */
+
+FrozenBinTree::~FrozenBinTree() {
+    clear();
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * freeze -----------------------------------------------------------------------------------------------------------------------------------------
+ * freeze : hands the NodeData of sourceTree over in order, then deals them out to the Eytzinger slots in inorder
+ * order of the implicit tree, so slot k ends up holding the value a balanced BST would put at that position.
+ * Each slot's key prefix is computed once here.
+ *
+ * @param sourceTree : BinTree to be frozen
+ * pre: none
+ * post: this holds every NodeData of sourceTree, which is empty; what this held before is deallocated
+ */
+
+void FrozenBinTree::freeze(BinTree &sourceTree) {
+    clear();
+    vector<NodeData*> sorted;
+    sorted.reserve(sourceTree.size());
+    sourceTree.bstreeToArray(sorted);
+
+    prefixes.resize(sorted.size() + 1);
+    items.resize(sorted.size() + 1);
+    size_t k = firstIndex();
+    for (size_t i = 0; i < sorted.size(); i++) {
+        items[k] = sorted[i];
+        prefixes[k] = sorted[i]->prefix();
+        k = nextIndex(k);
+    }
+}
+
+
+/**
+ * clear ------------------------------------------------------------------------------------------------------------------------------------------
+ * clear : deallocates every NodeData and empties both arrays
+ */
+
+void FrozenBinTree::clear() {
+    for (size_t k = 1; k < items.size(); k++) {
+        delete items[k];
+    }
+    items.clear();
+    prefixes.clear();
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
+ * to be NodeData object, if found
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree
+ * @return: the boolean value whether object is found
+ */
+
+bool FrozenBinTree::retrieve(const NodeData &dataDesired, NodeData* &dataRetrieved) const {
+    size_t k = lowerBoundIndex(dataDesired);
+    if (k != 0 && *items[k] == dataDesired) {
+        dataRetrieved = items[k];
+        return true;
+    }
+    dataRetrieved = NULL;                           // NodeData not in tree
+    return false;
+}
+
+
+/**
+ * lower_bound ------------------------------------------------------------------------------------------------------------------------------
+ * lower_bound : returns the first NodeData not less than key
+ *
+ * @param key : value to search for
+ * pre: key must be able to be comparable
+ * @return: the first NodeData >= key, or NULL if none
+ */
+
+const NodeData* FrozenBinTree::lower_bound(const NodeData &key) const {
+    size_t k = lowerBoundIndex(key);
+    return (k == 0) ? NULL : items[k];
+}
+
+
+/**
+ * getHeight ---------------------------------------------------------------------------------------------------------------------------------
+ * getHeight : returns the height of the implicit subtree rooted at dataDesired. The implicit tree is complete, so
+ * its leftmost path is a longest one and the height is the number of times the index can be doubled in range.
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @return: the height of the tree at the given node, 1 if leaf, 0 if not found
+ */
+
+int FrozenBinTree::getHeight(const NodeData &dataDesired) const {
+    size_t k = lowerBoundIndex(dataDesired);
+    if (k == 0 || *items[k] != dataDesired) {
+        return 0;                                   // doesn't exist is 0
+    }
+    int height = 0;
+    for (; k < items.size(); k *= 2) {
+        height++;
+    }
+    return height;
+}
+
+
+/**
+ * size -------------------------------------------------------------------------------------------------------------------------------------
+ * size : returns the number of NodeData in the index
+ */
+
+int FrozenBinTree::size() const {
+    return items.empty() ? 0 : (int)items.size() - 1;
+}
+
+
+/**
+ * isEmpty ----------------------------------------------------------------------------------------------------------------------------------
+ * isEmpty : true if the index holds no NodeData
+ */
+
+bool FrozenBinTree::isEmpty() const {
+    return size() == 0;
+}
+
+
+// Searching ///////////////////////////////////////////////////////////////////
+
+/**
+ * lowerBoundIndex --------------------------------------------------------------------------------------------------------------------------
+ * lowerBoundIndex : descends the implicit tree to the bottom on prefixes alone, going right exactly when the slot's
+ * prefix is less than key's. The step is computed from that one comparison rather than branched on, so every
+ * search takes the same number of iterations, and the prefixes PREFETCH_LEVELS levels below are requested while
+ * the current one is compared; near the bottom, where those levels do not exist, slot 0 is requested instead so no
+ * pointer is formed past the array. At the bottom, the right turns taken since the last left turn are undone, which
+ * leaves the first slot whose prefix is not less than key's. Only if that prefix equals key's can a NodeData decide
+ * the answer, and tiedIndex settles it.
+ *
+ * @param key : value to search for
+ * pre: key must be able to be comparable
+ * @return: Eytzinger index of the first NodeData >= key, 0 if none
+ */
+
+size_t FrozenBinTree::lowerBoundIndex(const NodeData &key) const {
+    size_t count = (size_t)size();
+    const unsigned long long* base = prefixes.data();
+    unsigned long long want = key.prefix();
+    size_t k = 1;
+    while (k <= count) {
+        size_t ahead = k << PREFETCH_LEVELS;
+        __builtin_prefetch(base + (ahead <= count ? ahead : 0));
+        k = 2 * k + (base[k] < want);
+    }
+    k >>= __builtin_ffsll(~(long long)k);           // undo trailing right turns
+    if (k != 0 && base[k] == want) {                // keys share key's prefix
+        k = tiedIndex(key, want);
+    }
+    return k;
+}
+
+
+/**
+ * tiedIndex --------------------------------------------------------------------------------------------------------------------------------
+ * tiedIndex : descends again like lowerBoundIndex, but compares NodeData wherever a slot's prefix equals key's, so
+ * slots sharing key's prefix are ordered by their full value
+ *
+ * @param key : value to search for
+ * @param want : key's prefix
+ * pre: some slot's prefix equals want
+ * @return: Eytzinger index of the first NodeData >= key, 0 if none
+ */
+
+size_t FrozenBinTree::tiedIndex(const NodeData &key, unsigned long long want) const {
+    size_t count = (size_t)size();
+    size_t k = 1;
+    while (k <= count) {
+        unsigned long long have = prefixes[k];
+        bool less = (have < want);
+        if (have == want) {
+            less = (*items[k] < key);
+        }
+        k = 2 * k + less;
+    }
+    k >>= __builtin_ffsll(~(long long)k);           // undo trailing right turns
+    return k;
+}
+
+
+/**
+ * firstIndex -------------------------------------------------------------------------------------------------------------------------------
+ * firstIndex : returns the Eytzinger index of the smallest NodeData, the leftmost slot, or 0 if empty
+ */
+
+size_t FrozenBinTree::firstIndex() const {
+    size_t count = (size_t)size();
+    if (count == 0) {
+        return 0;
+    }
+    size_t k = 1;
+    while (2 * k <= count) {
+        k *= 2;
+    }
+    return k;
+}
+
+
+/**
+ * nextIndex --------------------------------------------------------------------------------------------------------------------------------
+ * nextIndex : returns the Eytzinger index of the inorder successor of slot k: the leftmost slot of its right
+ * subtree if it has one, otherwise the first ancestor it lies to the left of
+ *
+ * @param k : a slot in range
+ * @return: index of the next larger NodeData, 0 if k holds the largest
+ */
+
+size_t FrozenBinTree::nextIndex(size_t k) const {
+    size_t count = (size_t)size();
+    if (2 * k + 1 <= count) {                       // leftmost of right subtree
+        k = 2 * k + 1;
+        while (2 * k <= count) {
+            k *= 2;
+        }
+        return k;
+    }
+    while (k & 1) {                                 // climb while a right child
+        k >>= 1;
+    }
+    return k >> 1;
+}
@@ -0,0 +1,114 @@
+//
+//  frozenbintree.h
+//
+//  FrozenBinTree Object: a read-only search index over the NodeData of a
+//  finished BinTree. Freezing takes the tree's NodeData in order (through
+//  bstreeToArray) and lays them out in one contiguous array in Eytzinger
+//  order: the root at index 1 and the children of index k at 2k and 2k + 1,
+//  so no child pointers are stored. Beside each NodeData* the first eight
+//  bytes of its key are kept inline, and lower_bound descends on those
+//  alone, without branches, prefetching the levels ahead of it. A NodeData
+//  is only dereferenced when two keys share the same eight-byte prefix.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- NodeData::prefix orders keys consistently with operator<, so a
+//        smaller prefix always means a smaller NodeData
+//     -- A frozen tree is never modified; freezing again replaces it whole
+//     -- A NodeData* returned by retrieve or lower_bound stays valid until
+//        the tree is frozen again or destroyed
+
+#ifndef FROZENBINTREE_H
+#define FROZENBINTREE_H
+#include <vector>
+#include "bintree.h"
+using namespace std;
+
+class FrozenBinTree {
+
+    // operator<< -------------------------------------------------------
+    // Prints an inorder traversal of the tree
+    friend ostream& operator<<(ostream &out, const FrozenBinTree &);
+
+public:
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // FrozenBinTree -----------------------------------------------------
+    // Default Constructor : creates an empty index
+    FrozenBinTree();
+
+    // FrozenBinTree -----------------------------------------------------
+    // Constructor : freezes the given BinTree, leaving it empty
+    explicit FrozenBinTree(BinTree &);
+
+    // ~FrozenBinTree ----------------------------------------------------
+    // Destructor : Deallocates all NodeData
+    ~FrozenBinTree();
+
+
+    // Mutators ////////////////////////////////////////////////////////////
+
+    // freeze ---------------------------------------------------------------
+    // deallocates this index, then takes over every NodeData of the given
+    // BinTree in linear time, leaving the BinTree empty
+    void freeze(BinTree &);
+
+
+    // Accessors ///////////////////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether data desired is in this tree,
+    // modifying the dataRetrieved directly to be NodeData object, if found
+    bool retrieve(const NodeData &, NodeData* &) const;
+
+    // lower_bound ----------------------------------------------------------
+    // returns the first NodeData not less than the given value, or NULL
+    const NodeData* lower_bound(const NodeData &) const;
+
+    // getHeight ------------------------------------------------------------
+    // returns the height of the implicit subtree holding the given value,
+    // 1 for a leaf and 0 if the value is not found
+    int getHeight(const NodeData &) const;
+
+    // size / isEmpty --------------------------------------------------------
+    // number of NodeData in the index, and whether it has none
+    int size() const;
+    bool isEmpty() const;
+
+private:
+    FrozenBinTree(const FrozenBinTree &) = delete;
+    FrozenBinTree& operator=(const FrozenBinTree &) = delete;
+
+    // levels skipped ahead by the prefetch in lower_bound: 2^3 = 8 prefixes,
+    // one cache line of descendants
+    static const int PREFETCH_LEVELS = 3;
+
+    vector<unsigned long long> prefixes;       // key prefixes, Eytzinger order
+    vector<NodeData*> items;                   // NodeData, same order
+                                               // index 0 of both is unused
+
+    // Utility functions //////////////////////////////////////////////
+
+    // lowerBoundIndex ------------------------------------------------------
+    // Eytzinger index of the first NodeData not less than the given value,
+    // 0 if none
+    size_t lowerBoundIndex(const NodeData &) const;
+
+    // tiedIndex ------------------------------------------------------------
+    // lowerBoundIndex for a value whose prefix other keys share, comparing
+    // their NodeData
+    size_t tiedIndex(const NodeData &, unsigned long long) const;
+
+    // firstIndex / nextIndex -----------------------------------------------
+    // Eytzinger index of the smallest NodeData, and of the next larger one
+    // after the given index; 0 past the end
+    size_t firstIndex() const;
+    size_t nextIndex(size_t) const;
+
+    // clear ----------------------------------------------------------------
+    // deallocates every NodeData and empties both arrays
+    void clear();
+};
+
+#endif
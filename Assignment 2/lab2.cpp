@@ -9,7 +9,12 @@
 // the last line of data so it acts like unix/linux.
 
 // presumably bintree.h includes nodedata.h so the include is not needed here
-#include "bintree.h"
+// treeengine.h picks BinTree, or BPlusTree when built with -DUSE_BPLUSTREE
+#include "treeengine.h"
+#include "treepipeline.h"
+#include "treetokenizer.h"
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 using namespace std;
@@ -17,18 +22,37 @@ using namespace std;
 const int ARRAYSIZE = 100;
 
 //global function prototypes
-void buildTree(BinTree&, ifstream&);      //
+bool buildTree(SearchTree&, TreeTokenizer&, bool = true);  // one tree
 void initArray(NodeData*[]);             // initialize array to NULL
 
-int main() {
+// usage: lab2 [-j workers] [datafile]
+// With -j the trees are tested by a TreePipeline of that many workers, which
+// prints the same output; bench/pipelinebench.cpp measures its throughput.
+
+int main(int argc, char* argv[]) {
+    int workers = 0;                    // 0 tests the trees one at a time
+    const char* path = "data2.txt";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+
     // create file object infile and open it
     // for testing, call your data file something appropriate, e.g., data2.txt
-    ifstream infile("data2.txt");
+    ifstream infile(path);
     if (!infile) {
         cout << "File could not be opened." << endl;
         return 1;
     }
 
+    if (workers > 0) {
+        TreePipeline(workers).run(infile, cout);
+        return 0;
+    }
+
     // the NodeData class must have a constructor that takes a string
     NodeData notND("not");
     NodeData andND("and");
@@ -40,15 +64,16 @@ int main() {
     NodeData mND("m");
     NodeData tND("t");
 
-    BinTree T, T2, dup;
+    SearchTree T, T2, dup;
     NodeData* ndArray[ARRAYSIZE];
     initArray(ndArray);
+    TreeTokenizer tokens(infile);
     cout << "Initial data:" << endl << "  ";
-    buildTree(T, infile);              // builds and displays initial data
+    bool more = buildTree(T, tokens);  // builds and displays initial data
     cout << endl;
-    BinTree first(T);                  // test copy constructor
+    SearchTree first(T);               // test copy constructor
     dup = dup = T;                     // test operator=, self-assignment
-    while (!infile.eof()) {
+    while (more) {
         cout << "Tree Inorder:" << endl << T;             // operator<< does endl
         T.displaySideways();
 
@@ -88,10 +113,12 @@ int main() {
 
         cout << "---------------------------------------------------------------"
             << endl;
-        cout << "Initial data:" << endl << "  ";
-        buildTree(T, infile);
-        cout << endl;
- 
+        more = !tokens.atEnd();         // no header once the data runs out
+        if (more) {
+            cout << "Initial data:" << endl << "  ";
+            buildTree(T, tokens);
+            cout << endl;
+        }
     }
  
 
@@ -99,28 +126,40 @@ int main() {
 }
 
 //------------------------------- buildTree ----------------------------------
-// YOU COMMENT
-
 // To build a tree, read strings from a line, terminating when "$$" is
 // encountered. Since there is some work to do before the actual insert that is
 // specific to the client problem, it's best that building a tree is not a
 // member function. It's a global function.
+// The strings come from the tokenizer, each NodeData built straight from its
+// slice of the input and echoed to cout if echo is true; a last string with
+// nothing after it is kept. Returns false only if the input had already run
+// out, so there was no tree to read.
 
-void buildTree(BinTree& T, ifstream& infile) {
-    string s;
+bool buildTree(SearchTree& T, TreeTokenizer& tokens, bool echo) {
+    const char* s;
+    size_t length;
+    bool read = false;                        // whether any token was found
 
     for (;;) {
-        infile >> s;
-        cout << s << ' ';
-        if (s == "$$") break;                // at end of one line
-        if (infile.eof()) break;             // no more lines of data
-        NodeData* ptr = new NodeData(s);     // NodeData constructor takes string
+        TreeTokenizer::Token token = tokens.next(s, length);
+        if (token == TreeTokenizer::INPUT_END) break;  // no more lines of data
+        read = true;
+        if (token == TreeTokenizer::TREE_END) {
+            if (echo) cout << "$$ ";
+            break;                            // at end of one line
+        }
+        if (echo) {
+            cout.write(s, length);
+            cout << ' ';
+        }
+        NodeData* ptr = new NodeData(s, length);  // copies the slice
         // would do a setData if there were more than a string
 
         bool success = T.insert(ptr);
         if (!success)
             delete ptr;                       // duplicate case, not inserted
     }
+    return read;
 }
 
 //------------------------------- initArray ----------------------------------
@@ -0,0 +1,226 @@
+//
+//  mappedbintree.cpp
+//
+//  MappedBinTree Object: a read-only view of a tree saved by BinTree::save,
+//  served straight out of the memory-mapped file. The file holds the keys
+//  in sorted order, packed end to end, with a table of where each one
+//  starts, so opening it parses nothing and allocates nothing per key, and
+//  retrieve binary searches the table in place. materialize turns the file
+//  into an ordinary BinTree in linear time when the tree must be modified.
+//
+//  File format (version 1, native byte order):
+//     -- FileHeader: magic, version, key count, total key bytes, and an
+//        FNV-1a checksum of everything after the header
+//     -- count + 1 offsets (uint64), offset i being where key i starts in
+//        the key bytes and the last one the total
+//     -- the key bytes, in ascending order
+//
+//  Assumptions:
+//     -- A file written on a machine of the other byte order is rejected by
+//        its magic number rather than misread
+//     -- The file must not be changed while it is open
+
+#include "mappedbintree.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+using namespace std;
+
+
+// Constructors //////////////////////////////////////////////////////////////
+
+/**
+ * MappedBinTree ----------------------------------------------------------------------------------------------------------------------------------
+ * Default Constructor : creates a view with no file open
+ */
+
+MappedBinTree::MappedBinTree() {
+    base = NULL;
+    length = 0;
+    offsets = NULL;
+    keys = NULL;
+    count = 0;
+}
+
+
+/**
+ * ~MappedBinTree ---------------------------------------------------------------------------------------------------------------------------------
+ * Destructor : unmaps the file, if one is open
+ */
+
+MappedBinTree::~MappedBinTree() {
+    close();
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * open -------------------------------------------------------------------------------------------------------------------------------------------
+ * open : maps the whole file read-only, then checks the header against the file length and the offsets to start at
+ * 0, never decrease and end at the key bytes' length, so no key read later can lie outside the mapping. With
+ * verify, neighbouring keys are also checked to be strictly ascending, as retrieve and materialize rely on, and the
+ * checksum is recomputed; each reads the key bytes once.
+ *
+ * @param path : file written by BinTree::save
+ * @param verify : true to check the key order and checksum before accepting the file
+ * pre: none
+ * post: on success the file is open and any file open before is closed; on failure nothing is open
+ * @return: true if the file was opened
+ */
+
+bool MappedBinTree::open(const string &path, bool verify) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);                                // the mapping stays valid
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    base = (const char*)mapped;
+    length = (size_t)info.st_size;
+
+    const FileHeader* header = (const FileHeader*)base;
+    uint64_t tableBytes = (header->count + 1) * sizeof(uint64_t);
+    bool valid = header->magic == MAGIC && header->version == VERSION
+        && header->count < length && header->keyBytes < length
+        && sizeof(FileHeader) + tableBytes + header->keyBytes == length;
+    if (valid) {
+        count = header->count;
+        offsets = (const uint64_t*)(base + sizeof(FileHeader));
+        keys = base + sizeof(FileHeader) + tableBytes;
+    }
+    if (valid) {
+        valid = offsets[0] == 0 && offsets[count] == header->keyBytes;
+        for (uint64_t i = 0; valid && i < count; i++) {
+            valid = offsets[i] <= offsets[i + 1];
+        }
+    }
+    if (valid && verify) {
+        for (uint64_t i = 1; valid && i < count; i++) {
+            NodeData previous(keys + offsets[i - 1], offsets[i] - offsets[i - 1]);
+            valid = previous.compare(keys + offsets[i], offsets[i + 1] - offsets[i]) < 0;
+        }
+        valid = valid && checksum(offsets, length - sizeof(FileHeader), CHECKSUM_SEED)
+            == header->checksum;
+    }
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+
+/**
+ * close ------------------------------------------------------------------------------------------------------------------------------------------
+ * close : unmaps the file, if one is open
+ */
+
+void MappedBinTree::close() {
+    if (base != NULL) {
+        munmap((void*)base, length);
+    }
+    base = NULL;
+    length = 0;
+    offsets = NULL;
+    keys = NULL;
+    count = 0;
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : binary searches the offsets table, comparing dataDesired against each key's bytes where they lie in
+ * the mapping
+ *
+ * @param dataDesired : value to be searched for
+ * pre: none
+ * post: nothing is allocated
+ * @return: the boolean value whether a key equal to dataDesired is in the file
+ */
+
+bool MappedBinTree::retrieve(const NodeData &dataDesired) const {
+    uint64_t low = 0;
+    uint64_t high = count;                      // search [low, high)
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        int order = dataDesired.compare(keys + offsets[mid], offsets[mid + 1] - offsets[mid]);
+        if (order == 0) {
+            return true;
+        } else if (order < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * size -------------------------------------------------------------------------------------------------------------------------------------
+ * size : returns the number of keys in the file, 0 if none is open
+ */
+
+int MappedBinTree::size() const {
+    return (int)count;
+}
+
+
+/**
+ * isOpen -----------------------------------------------------------------------------------------------------------------------------------
+ * isOpen : true if a file is mapped
+ */
+
+bool MappedBinTree::isOpen() const {
+    return base != NULL;
+}
+
+
+/**
+ * materialize ------------------------------------------------------------------------------------------------------------------------------
+ * materialize : creates one NodeData per key and hands them to targetTree's arrayToBSTree. The keys are already
+ * sorted and distinct, so the tree is linked directly without a comparison.
+ *
+ * @param targetTree : BinTree to be filled; its balancing mode is kept
+ * pre: none
+ * post: targetTree holds a NodeData for each key of the file, as a balanced tree
+ */
+
+void MappedBinTree::materialize(BinTree &targetTree) const {
+    vector<NodeData*> items;
+    items.reserve(count);
+    for (uint64_t i = 0; i < count; i++) {
+        items.push_back(new NodeData(keys + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+    targetTree.arrayToBSTree(items.data(), (int)items.size());
+}
+
+
+/**
+ * checksum ---------------------------------------------------------------------------------------------------------------------------------
+ * checksum : 64-bit FNV-1a, continued from hash over length more bytes, so a file can be hashed in pieces
+ *
+ * @return: the hash after bytes
+ */
+
+uint64_t MappedBinTree::checksum(const void* bytes, size_t length, uint64_t hash) {
+    const unsigned char* cur = (const unsigned char*)bytes;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= cur[i];
+        hash *= 1099511628211ULL;               // FNV 64-bit prime
+    }
+    return hash;
+}
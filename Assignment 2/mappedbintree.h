@@ -0,0 +1,105 @@
+//
+//  mappedbintree.h
+//
+//  MappedBinTree Object: a read-only view of a tree saved by BinTree::save,
+//  served straight out of the memory-mapped file. The file holds the keys
+//  in sorted order, packed end to end, with a table of where each one
+//  starts, so opening it parses nothing and allocates nothing per key, and
+//  retrieve binary searches the table in place. materialize turns the file
+//  into an ordinary BinTree in linear time when the tree must be modified.
+//
+//  File format (version 1, native byte order):
+//     -- FileHeader: magic, version, key count, total key bytes, and an
+//        FNV-1a checksum of everything after the header
+//     -- count + 1 offsets (uint64), offset i being where key i starts in
+//        the key bytes and the last one the total
+//     -- the key bytes, in ascending order
+//
+//  Assumptions:
+//     -- A file written on a machine of the other byte order is rejected by
+//        its magic number rather than misread
+//     -- The file must not be changed while it is open
+
+#ifndef MAPPEDBINTREE_H
+#define MAPPEDBINTREE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bintree.h"
+using namespace std;
+
+class MappedBinTree {
+
+public:
+    // Fixed-size start of a saved tree
+    struct FileHeader {
+        uint32_t magic;                        // MAGIC
+        uint32_t version;                      // VERSION
+        uint64_t count;                        // number of keys
+        uint64_t keyBytes;                     // total length of all keys
+        uint64_t checksum;                     // FNV-1a of offsets and keys
+    };
+    static const uint32_t MAGIC = 0x31525442;  // "BTR1" read little-endian
+    static const uint32_t VERSION = 1;
+
+    // checksum -------------------------------------------------------------
+    // continues a 64-bit FNV-1a hash from the given value over more bytes;
+    // start from CHECKSUM_SEED
+    static uint64_t checksum(const void *, size_t, uint64_t);
+    static const uint64_t CHECKSUM_SEED = 14695981039346656037ULL;
+
+
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // MappedBinTree -----------------------------------------------------
+    // Default Constructor : creates a view with no file open
+    MappedBinTree();
+
+    // ~MappedBinTree ----------------------------------------------------
+    // Destructor : unmaps the file, if one is open
+    ~MappedBinTree();
+
+
+    // Mutators ////////////////////////////////////////////////////////////
+
+    // open -----------------------------------------------------------------
+    // maps the saved tree at path. Returns false, with nothing open, if the
+    // file is missing, too short, of another format or version, has bad
+    // offsets, or (when verify is true) has keys out of order or a bad
+    // checksum
+    bool open(const string &path, bool verify = true);
+
+    // close ----------------------------------------------------------------
+    // unmaps the file
+    void close();
+
+
+    // Accessors ///////////////////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether data desired is in the file,
+    // searched in place without allocating
+    bool retrieve(const NodeData &) const;
+
+    // size / isOpen ---------------------------------------------------------
+    // number of keys in the file, 0 if none is open, and whether one is
+    int size() const;
+    bool isOpen() const;
+
+    // materialize ----------------------------------------------------------
+    // empties the given BinTree and fills it with one NodeData per key,
+    // built balanced in linear time without comparing any keys
+    void materialize(BinTree &) const;
+
+private:
+    MappedBinTree(const MappedBinTree &) = delete;
+    MappedBinTree& operator=(const MappedBinTree &) = delete;
+
+    const char* base;                          // start of the mapping
+    size_t length;                             // bytes mapped
+    const uint64_t* offsets;                   // count + 1 offsets
+    const char* keys;                          // key bytes
+    uint64_t count;                            // number of keys
+};
+
+#endif
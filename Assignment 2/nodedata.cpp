@@ -1,4 +1,9 @@
 #include "nodedata.h"
+#include "outputbuffer.h"
+
+#ifdef NODEDATA_COUNT_COMPARES
+unsigned long long nodeDataCompares = 0;    // see nodedata.h
+#endif
 
 //------------------- constructors/destructor  -------------------------------
 NodeData::NodeData() { data = ""; }                         // default
@@ -7,8 +12,12 @@ NodeData::~NodeData() { }            // needed so strings are deleted properly
 
 NodeData::NodeData(const NodeData& nd) { data = nd.data; }  // copy
 
+NodeData::NodeData(NodeData&& nd) noexcept : data(std::move(nd.data)) { } // move
+
 NodeData::NodeData(const string& s) { data = s; }    // cast string to NodeData
 
+NodeData::NodeData(const char* s, size_t length) : data(s, length) { } // slice
+
 //------------------------- operator= ----------------------------------------
 NodeData& NodeData::operator=(const NodeData& rhs) {
 	if (this != &rhs) {
@@ -17,30 +26,28 @@ NodeData& NodeData::operator=(const NodeData& rhs) {
 	return *this;
 }
 
-//------------------------- operator==,!= ------------------------------------
-bool NodeData::operator==(const NodeData& rhs) const {
-	return data == rhs.data;
-}
-
-bool NodeData::operator!=(const NodeData& rhs) const {
-	return data != rhs.data;
-}
-
-//------------------------ operator<,>,<=,>= ---------------------------------
-bool NodeData::operator<(const NodeData& rhs) const {
-	return data < rhs.data;
-}
-
-bool NodeData::operator>(const NodeData& rhs) const {
-	return data > rhs.data;
+NodeData& NodeData::operator=(NodeData&& rhs) noexcept {
+	if (this != &rhs) {
+		data = std::move(rhs.data);
+	}
+	return *this;
 }
 
-bool NodeData::operator<=(const NodeData& rhs) const {
-	return data <= rhs.data;
+//------------------------------- swap ---------------------------------------
+void NodeData::swap(NodeData& other) noexcept {
+	data.swap(other.data);
 }
 
-bool NodeData::operator>=(const NodeData& rhs) const {
-	return data >= rhs.data;
+//------------------------------- prefix -------------------------------------
+unsigned long long NodeData::prefix() const {
+	unsigned long long packed = 0;
+	for (size_t i = 0; i < sizeof(packed); i++) {
+		packed <<= 8;
+		if (i < data.size()) {
+			packed |= (unsigned char)data[i];
+		}
+	}
+	return packed;
 }
 
 //------------------------------ setData -------------------------------------
@@ -56,3 +63,10 @@ ostream& operator<<(ostream& output, const NodeData& nd) {
 	output << nd.data;
 	return output;
 }
+
+//---------------------------- appendTo --------------------------------------
+// the buffered form of operator<<, used by the trees' output; the two must
+// print the same characters
+void NodeData::appendTo(OutputBuffer& buffer) const {
+	buffer.append(data);
+}
@@ -5,6 +5,8 @@
 #include <fstream>
 using namespace std;
 
+class OutputBuffer;
+
 // simple class containing one string to use for testing
 // not necessary to comment further
 
@@ -15,8 +17,12 @@ public:
     NodeData();          // default constructor, data is set to an empty string
     ~NodeData();
     NodeData(const string &);      // data is set equal to parameter
+    NodeData(const char *, size_t);    // data is set to the given characters
     NodeData(const NodeData &);    // copy constructor
+    NodeData(NodeData &&) noexcept;    // move constructor, steals the string
     NodeData& operator=(const NodeData &);
+    NodeData& operator=(NodeData &&) noexcept;
+    void swap(NodeData &) noexcept;    // exchanges data with parameter
 
     // set class data from data file
     // returns true if the data is set, false when bad data, i.e., is eof
@@ -29,8 +35,46 @@ public:
     bool operator<=(const NodeData &) const;
     bool operator>=(const NodeData &) const;
 
+    // three-way comparison with one pass over the strings: negative if this
+    // is smaller than the parameter, zero if equal, positive if larger
+    int compare(const NodeData &) const;
+    int compare(const char *, size_t) const;    // against raw characters
+
+    const string& getData() const;     // the string itself, e.g. for saving
+
+    // adds the characters operator<< prints to a tree's output buffer
+    void appendTo(OutputBuffer &) const;
+
+    // first eight bytes of data packed big-endian and zero padded, so a
+    // smaller prefix always means a smaller NodeData
+    unsigned long long prefix() const;
+
 private:
     string data;
 };
 
+inline void swap(NodeData &lhs, NodeData &rhs) noexcept { lhs.swap(rhs); }
+
+// comparisons are defined here so every tree that compares NodeData can
+// inline them instead of calling into nodedata.cpp. Built with
+// -DNODEDATA_COUNT_COMPARES, each one also adds one to nodeDataCompares so
+// a benchmark can count them; the count is not safe to share across threads
+#ifdef NODEDATA_COUNT_COMPARES
+extern unsigned long long nodeDataCompares;
+#define NODEDATA_COUNTED(result) (++nodeDataCompares, (result))
+#else
+#define NODEDATA_COUNTED(result) (result)
+#endif
+inline bool NodeData::operator==(const NodeData& rhs) const { return NODEDATA_COUNTED(data == rhs.data); }
+inline bool NodeData::operator!=(const NodeData& rhs) const { return NODEDATA_COUNTED(data != rhs.data); }
+inline bool NodeData::operator<(const NodeData& rhs) const { return NODEDATA_COUNTED(data < rhs.data); }
+inline bool NodeData::operator>(const NodeData& rhs) const { return NODEDATA_COUNTED(data > rhs.data); }
+inline bool NodeData::operator<=(const NodeData& rhs) const { return NODEDATA_COUNTED(data <= rhs.data); }
+inline bool NodeData::operator>=(const NodeData& rhs) const { return NODEDATA_COUNTED(data >= rhs.data); }
+inline int NodeData::compare(const NodeData& rhs) const { return NODEDATA_COUNTED(data.compare(rhs.data)); }
+inline int NodeData::compare(const char* rhs, size_t length) const {
+	return NODEDATA_COUNTED(data.compare(0, string::npos, rhs, length));
+}
+inline const string& NodeData::getData() const { return data; }
+
 #endif
@@ -0,0 +1,88 @@
+//
+//  outputbuffer.h
+//
+//  OutputBuffer Object: gathers text for a stream in one large string and
+//  hands it over with a single write whenever CAPACITY bytes are waiting,
+//  and when it is flushed or destroyed. The trees print through it, so
+//  printing a tree of n Nodes costs a few large writes rather than n
+//  formatted insertions, and nothing is flushed until the caller chooses.
+//
+//  Assumptions:
+//     -- Nothing else writes to the stream while a buffer for it holds text,
+//        or the two outputs interleave out of order
+//     -- The stream reports write errors through its state, as usual
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+#include <cstddef>
+#include <ostream>
+#include <string>
+using namespace std;
+
+class OutputBuffer {
+
+public:
+    // bytes gathered before they are written to the stream
+    static const size_t CAPACITY = 1 << 16;
+
+    // OutputBuffer -------------------------------------------------------
+    // Constructor : gathers text for the given stream
+    explicit OutputBuffer(ostream &out) : out(out) {
+        text.reserve(CAPACITY);
+    }
+
+    // ~OutputBuffer ------------------------------------------------------
+    // Destructor : writes whatever is left
+    ~OutputBuffer() {
+        flush();
+    }
+
+    // append ---------------------------------------------------------------
+    // adds characters, writing the buffer out once it is full
+    void append(const string &s) {
+        text += s;
+        spill();
+    }
+    void append(const char* s) {
+        text += s;
+        spill();
+    }
+    void append(char c) {
+        text += c;
+        spill();
+    }
+
+    // indent ---------------------------------------------------------------
+    // adds the given number of four-space groups
+    void indent(int groups) {
+        if (groups > 0) {
+            text.append(4 * (size_t)groups, ' ');
+        }
+    }
+
+    // flush ----------------------------------------------------------------
+    // writes the gathered text to the stream, without flushing the stream
+    void flush() {
+        if (!text.empty()) {
+            out.write(text.data(), (streamsize)text.size());
+            text.clear();
+        }
+    }
+
+private:
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer& operator=(const OutputBuffer &) = delete;
+
+    // spill ----------------------------------------------------------------
+    // writes the buffer out once it holds CAPACITY bytes
+    void spill() {
+        if (text.size() >= CAPACITY) {
+            flush();
+        }
+    }
+
+    ostream &out;                              // destination
+    string text;                               // gathered, not yet written
+};
+
+#endif
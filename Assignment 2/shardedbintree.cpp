@@ -0,0 +1,208 @@
+//
+//  shardedbintree.cpp
+//
+//  ShardedBinTree Object: a front end over several BinTrees that lets many
+//  threads insert at once. The key space is cut into ranges by a sorted list
+//  of splitter values, and each range is held by its own BinTree guarded by
+//  its own mutex, so writers only wait on each other when their keys fall in
+//  the same range. Because the ranges are ordered, walking the shards in
+//  turn gives the same inorder sequence a single BinTree would.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- insert keeps the BinTree contract: false means newData was a
+//        duplicate and still belongs to the caller, who must delete it
+//     -- A NodeData* returned by retrieve stays valid until that NodeData is
+//        removed or the tree is emptied
+//     -- getHeight reports the height within the shard holding the value
+
+#include "shardedbintree.h"
+#include <algorithm>
+using namespace std;
+
+
+/**
+ * operator<< --------------------------------------------------------------------------------------------------------------------------------------
+ * overloaded operator<< : Prints an inorder traversal of the tree, one shard after another
+ * pre: none
+ * post: prints each shard's NodeData in order, separated by spaces, followed by endl
+ */
+
+ostream& operator<<(ostream &out, const ShardedBinTree &outputTree) {
+    for (int i = 0; i < outputTree.shardCount(); i++) {
+        ShardedBinTree::Shard &shard = outputTree.shards[i];
+        lock_guard<mutex> lock(shard.lock);
+        for (BinTree::const_iterator it = shard.tree.begin(); it != shard.tree.end(); ++it) {
+            out << *it << " ";
+        }
+    }
+    out << endl;
+    return out;
+}
+
+
+// Constructors //////////////////////////////////////////////////////////////
+
+/**
+ * ShardedBinTree ---------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : creates one empty shard per range cut out by splitters
+ *
+ * @param splitters : range boundaries; sorted into order and made distinct if they are not already
+ * @param balanced : true if every shard should be an AVL balanced BinTree
+ */
+
+ShardedBinTree::ShardedBinTree(const vector<NodeData> &splitters, bool balanced)
+    : splitters(splitters) {
+    sort(this->splitters.begin(), this->splitters.end());
+    this->splitters.erase(unique(this->splitters.begin(), this->splitters.end()),
+                          this->splitters.end());
+    shards.reset(new Shard[this->splitters.size() + 1]);
+    for (int i = 0; i < shardCount(); i++) {
+        shards[i].tree = BinTree(balanced);
+    }
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * insert -------------------------------------------------------------------
+ * insert : inserts newData into the shard owning its range, holding only that shard's lock
+ *
+ * @param newData : the new newData object to be added to the tree
+ * pre: newData object must be able to be comparable
+ * post: if not a duplicate, newData is owned by the tree
+ * @return: the boolean value of success of insertion; false leaves newData owned by the caller
+ */
+
+bool ShardedBinTree::insert(NodeData* newData) {
+    Shard &shard = shardFor(*newData);
+    lock_guard<mutex> lock(shard.lock);
+    return shard.tree.insert(newData);
+}
+
+
+/**
+ * remove -------------------------------------------------------------------
+ * remove : removes the NodeData equal to target from the shard owning its range
+ *
+ * @param target : the NodeData value to be removed from the tree
+ * pre: target object must be able to be comparable
+ * post: the matching NodeData is deallocated
+ * @return: true if a NodeData was removed, false if target was not in the tree
+ */
+
+bool ShardedBinTree::remove(const NodeData &target) {
+    Shard &shard = shardFor(target);
+    lock_guard<mutex> lock(shard.lock);
+    return shard.tree.remove(target);
+}
+
+
+/**
+ * makeEmpty ------------------------------------------------------------------------------------------------------------------------------
+ * makeEmpty : deallocates every shard's Nodes and NodeData, one shard at a time
+ */
+
+void ShardedBinTree::makeEmpty() {
+    for (int i = 0; i < shardCount(); i++) {
+        lock_guard<mutex> lock(shards[i].lock);
+        shards[i].tree.makeEmpty();
+    }
+}
+
+
+/**
+ * drainInto ------------------------------------------------------------------------------------------------------------------------------
+ * drainInto : hands every shard's NodeData over in order and bulk loads them into target. Since each shard's
+ * range lies wholly below the next one's, the combined sequence is already sorted and distinct.
+ *
+ * @param target : BinTree to receive every NodeData; its previous contents are deallocated
+ * pre: no other thread is using this tree
+ * post: target holds every NodeData as a balanced tree, and this tree is empty
+ */
+
+void ShardedBinTree::drainInto(BinTree &target) {
+    vector<NodeData*> all;
+    for (int i = 0; i < shardCount(); i++) {
+        lock_guard<mutex> lock(shards[i].lock);
+        shards[i].tree.bstreeToArray(all);
+    }
+    target.bulkLoad(all);
+}
+
+
+// Accessors ////////////////////////////////////////////////////////////////////
+
+/**
+ * retrieve -------------------------------------------------------------------------------------------------------------------------------------------
+ * retrieve : returns the bool value of whether data desired is in this tree, modifying the dataRetrieved directly
+ * to be NodeData object, if found
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @param dataRetrieved : newData object to point to object in tree, if found
+ * pre: newData object must be able to be comparable
+ * post: if found, returns true and dataRetrieved points to object in tree
+ * @return: the boolean value whether object is found
+ */
+
+bool ShardedBinTree::retrieve(const NodeData &dataDesired, NodeData* &dataRetrieved) {
+    Shard &shard = shardFor(dataDesired);
+    lock_guard<mutex> lock(shard.lock);
+    return shard.tree.retrieve(dataDesired, dataRetrieved);
+}
+
+
+/**
+ * getHeight ---------------------------------------------------------------------------------------------------------------------------------
+ * getHeight : returns the height of dataDesired within the shard that holds it
+ *
+ * @param dataDesired : pass-by-reference newData object to be searched for in tree
+ * @return: the height of the shard's tree at the given node, 1 if leaf, 0 if not found
+ */
+
+int ShardedBinTree::getHeight(const NodeData &dataDesired) {
+    Shard &shard = shardFor(dataDesired);
+    lock_guard<mutex> lock(shard.lock);
+    return shard.tree.getHeight(dataDesired);
+}
+
+
+/**
+ * size -------------------------------------------------------------------------------------------------------------------------------------
+ * size : returns the total number of NodeData, summed shard by shard
+ */
+
+int ShardedBinTree::size() {
+    int total = 0;
+    for (int i = 0; i < shardCount(); i++) {
+        lock_guard<mutex> lock(shards[i].lock);
+        total += shards[i].tree.size();
+    }
+    return total;
+}
+
+
+/**
+ * shardCount -------------------------------------------------------------------------------------------------------------------------------
+ * shardCount : returns the number of shards, one more than the number of splitters
+ */
+
+int ShardedBinTree::shardCount() const {
+    return (int)splitters.size() + 1;
+}
+
+
+/**
+ * shardFor ---------------------------------------------------------------------------------------------------------------------------------
+ * shardFor : binary searches the splitters for the range holding value
+ *
+ * @param value : value whose shard is wanted
+ * @return: shard i where i is the number of splitters less than or equal to value
+ */
+
+ShardedBinTree::Shard& ShardedBinTree::shardFor(const NodeData &value) const {
+    size_t index = upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin();
+    return shards[index];
+}
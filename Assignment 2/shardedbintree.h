@@ -0,0 +1,101 @@
+//
+//  shardedbintree.h
+//
+//  ShardedBinTree Object: a front end over several BinTrees that lets many
+//  threads insert at once. The key space is cut into ranges by a sorted list
+//  of splitter values, and each range is held by its own BinTree guarded by
+//  its own mutex, so writers only wait on each other when their keys fall in
+//  the same range. Because the ranges are ordered, walking the shards in
+//  turn gives the same inorder sequence a single BinTree would.
+//
+//  Assumptions:
+//     -- Input assumed to be correct and consist of NodeData objects, to be
+//        implemented by client
+//     -- insert keeps the BinTree contract: false means newData was a
+//        duplicate and still belongs to the caller, who must delete it
+//     -- A NodeData* returned by retrieve stays valid until that NodeData is
+//        removed or the tree is emptied
+//     -- getHeight reports the height within the shard holding the value
+
+#ifndef SHARDEDBINTREE_H
+#define SHARDEDBINTREE_H
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "bintree.h"
+using namespace std;
+
+class ShardedBinTree {
+
+    // operator<< -------------------------------------------------------
+    // Prints an inorder traversal of every shard in turn
+    friend ostream& operator<<(ostream &out, const ShardedBinTree &);
+
+public:
+    // Constructor/Destructor //////////////////////////////////////////////
+
+    // ShardedBinTree ----------------------------------------------------
+    // Constructor : creates splitters.size() + 1 empty shards. Shard i holds
+    // values v with splitters[i - 1] <= v < splitters[i]. Each shard is AVL
+    // balanced if balanced is true
+    explicit ShardedBinTree(const vector<NodeData> &splitters,
+                            bool balanced = true);
+
+
+    // Mutators (thread-safe) //////////////////////////////////////////////
+
+    // insert ---------------------------------------------------------------
+    // inserts newData into the shard owning its range, locking only that
+    // shard. Returns false for a duplicate, which the caller then deletes
+    bool insert(NodeData*);
+
+    // remove ---------------------------------------------------------------
+    // removes and deallocates the NodeData equal to the input, if present
+    bool remove(const NodeData &);
+
+    // makeEmpty ------------------------------------------------------------
+    // deallocates every shard's Nodes and NodeData
+    void makeEmpty();
+
+    // drainInto ------------------------------------------------------------
+    // moves every NodeData into the given BinTree as one balanced tree,
+    // built in linear time, leaving this tree empty
+    void drainInto(BinTree &);
+
+
+    // Accessors (thread-safe) /////////////////////////////////////////////
+
+    // retrieve ------------------------------------------------------------
+    // returns the bool value of whether data desired is in this tree,
+    // modifying the dataRetrieved directly to be NodeData object, if found
+    bool retrieve(const NodeData &, NodeData* &);
+
+    // getHeight ------------------------------------------------------------
+    // returns the height of the given value within its shard, 0 if not found
+    int getHeight(const NodeData &);
+
+    // size / shardCount -----------------------------------------------------
+    // total number of NodeData, and number of shards
+    int size();
+    int shardCount() const;
+
+private:
+    ShardedBinTree(const ShardedBinTree &) = delete;
+    ShardedBinTree& operator=(const ShardedBinTree &) = delete;
+
+    // One key range and the lock guarding it
+    struct Shard {
+        BinTree tree;                          // values in this range
+        mutex lock;                            // guards tree
+    };
+
+    vector<NodeData> splitters;                // sorted range boundaries
+    unique_ptr<Shard[]> shards;                // splitters.size() + 1 shards,
+                                               // deallocated with this tree
+
+    // shardFor -------------------------------------------------------------
+    // returns the shard whose range holds the given value
+    Shard& shardFor(const NodeData &) const;
+};
+
+#endif
@@ -0,0 +1,164 @@
+//
+//  concurrentstress.cpp
+//
+//  Threaded driver for ConcurrentBinTree, meant to be built with
+//  -fsanitize=thread or -fsanitize=address. Reader threads search a tree
+//  while a writer inserts into it, and a second tree is filled and emptied
+//  over and over while readers walk it, so retired Nodes and whole retired
+//  trees are freed while others still read. Readers check every answer
+//  against what the writer has published so far; afterwards the tree is
+//  checked against a serial std::set of the same keys, and every retired
+//  Node must have been deallocated.
+//
+//  usage: concurrentstress [inserts [readers]]    defaults 20000, 4
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O1 -g -fsanitize=thread -pthread -I.
+//         stress/concurrentstress.cpp concurrentbintree.cpp nodedata.cpp
+//         -o concurrentstress
+//
+//  Assumptions:
+//     -- Exits with status 1 and a message on the first wrong answer
+
+#include "concurrentbintree.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+const int PRELOADED = 1000;                    // keys present from the start
+
+// keyFor: the i-th key; zero padding makes key order match i
+string keyFor(int i) {
+    char text[16];
+    snprintf(text, sizeof(text), "k%09d", i);
+    return text;
+}
+
+// fail: reports a wrong answer and stops every thread
+void fail(const string &what) {
+    cerr << "concurrentstress: " << what << endl;
+    exit(1);
+}
+
+// checkOrder: walks one version of tree, which must be strictly ascending
+// and hold at least atLeast keys; returns how many it held
+int checkOrder(const ConcurrentBinTree &tree, int atLeast) {
+    int count = 0;
+    string last;
+    tree.forEach([&](const NodeData &data) {
+        if (count > 0 && !(last < data.getData())) {
+            fail("forEach out of order at " + data.getData());
+        }
+        last = data.getData();
+        count++;
+    });
+    if (count < atLeast) {
+        fail("forEach saw fewer keys than were published");
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    int inserts = argc > 1 ? atoi(argv[1]) : 20000;
+    int readers = argc > 2 ? atoi(argv[2]) : 4;
+
+    ConcurrentBinTree tree, churned;
+    set<string> reference;
+    for (int i = 0; i < PRELOADED; i++) {
+        tree.insert(new NodeData(keyFor(i)));
+        reference.insert(keyFor(i));
+    }
+
+    atomic<int> published(0);                  // inserted after PRELOADED
+    atomic<bool> done(false);
+    vector<thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.push_back(thread([&, r]() {
+            unsigned seed = r + 1;
+            long rounds = 0;
+            while (!done.load()) {
+                int seen = published.load();
+                int present = rand_r(&seed) % (PRELOADED + seen);
+                const NodeData* found = NULL;
+                if (!tree.retrieve(NodeData(keyFor(present)), found)
+                    || found->getData() != keyFor(present)) {
+                    fail("published key not found: " + keyFor(present));
+                }
+                if (tree.getHeight(NodeData(keyFor(present))) < 1) {
+                    fail("published key has no height: " + keyFor(present));
+                }
+                int absent = PRELOADED + inserts + rand_r(&seed) % 1000;
+                if (tree.retrieve(NodeData(keyFor(absent)), found)) {
+                    fail("key never inserted was found: " + keyFor(absent));
+                }
+                if (rounds++ % 64 == 0) {
+                    checkOrder(tree, PRELOADED + seen);
+                    checkOrder(churned, 0);
+                }
+                // churned may be emptied at any moment, so its NodeData
+                // are only read through the copying retrieve
+                NodeData copy;
+                if (churned.retrieve(NodeData(keyFor(present % 100)), copy)
+                    && copy.getData() != keyFor(present % 100)) {
+                    fail("churned tree copied out the wrong NodeData");
+                }
+            }
+        }));
+    }
+
+    // one writer, taking turns between the two trees
+    for (int i = 0; i < inserts; i++) {
+        int key = PRELOADED + i;
+        if (!tree.insert(new NodeData(keyFor(key)))) {
+            fail("insert of a new key returned false");
+        }
+        published.store(i + 1);
+        NodeData* duplicate = new NodeData(keyFor(key / 2));
+        if (tree.insert(duplicate)) {
+            fail("insert of a duplicate returned true");
+        }
+        delete duplicate;                      // caller keeps duplicates
+        churned.insert(new NodeData(keyFor(i % 100)));
+        if (i % 100 == 99) {
+            churned.makeEmpty();
+        }
+    }
+    done = true;
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    // serial reference holds the same keys in the same order
+    for (int i = 0; i < inserts; i++) {
+        reference.insert(keyFor(PRELOADED + i));
+    }
+    set<string>::const_iterator expected = reference.begin();
+    tree.forEach([&](const NodeData &data) {
+        if (expected == reference.end() || *expected != data.getData()) {
+            fail("tree differs from the serial reference at "
+                 + data.getData());
+        }
+        ++expected;
+    });
+    if (expected != reference.end() || tree.size() != (int)reference.size()) {
+        fail("tree is missing keys of the serial reference");
+    }
+
+    // with no reader left, a few writes must free everything retired
+    for (int i = 0; i < 3; i++) {
+        tree.makeEmpty();
+        churned.makeEmpty();
+    }
+    if (tree.retiredCount() != 0 || churned.retiredCount() != 0) {
+        fail("retired Nodes were never deallocated");
+    }
+    cout << "concurrentstress: OK, " << reference.size() << " keys, "
+         << readers << " readers" << endl;
+    return 0;
+}
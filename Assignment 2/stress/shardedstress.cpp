@@ -0,0 +1,170 @@
+//
+//  shardedstress.cpp
+//
+//  Threaded driver for ShardedBinTree, meant to be built with
+//  -fsanitize=thread or -fsanitize=address. Several threads insert, remove
+//  and retrieve at once across every shard. Each thread owns the keys equal
+//  to its number modulo the thread count and checks every answer against its
+//  own serial std::set; all threads also race to insert one shared set of
+//  keys, where exactly one insert per key may succeed. At the end the tree
+//  is drained into a BinTree and compared with the merged serial reference.
+//
+//  usage: shardedstress [operations [threads]]    defaults 40000, 4
+//
+//  Build from the "Assignment 2" directory:
+//     g++ -std=gnu++14 -O1 -g -fsanitize=thread -pthread -I.
+//         stress/shardedstress.cpp shardedbintree.cpp bintree.cpp
+//         mappedbintree.cpp nodedata.cpp -o shardedstress
+//
+//  Assumptions:
+//     -- Exits with status 1 and a message on the first wrong answer
+
+#include "shardedbintree.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+const int OWNED = 4000;                        // keys split among threads
+const int SHARED = 1000;                       // keys every thread inserts
+const int SHARDS = 8;
+
+// keyFor: the i-th key; zero padding makes key order match i
+string keyFor(int i) {
+    char text[16];
+    snprintf(text, sizeof(text), "k%09d", i);
+    return text;
+}
+
+// fail: reports a wrong answer and stops every thread
+void fail(const string &what) {
+    cerr << "shardedstress: " << what << endl;
+    exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    int operations = argc > 1 ? atoi(argv[1]) : 40000;
+    int threadCount = argc > 2 ? atoi(argv[2]) : 4;
+
+    vector<NodeData> splitters;
+    for (int s = 1; s < SHARDS; s++) {
+        splitters.push_back(NodeData(keyFor(s * (OWNED + SHARED) / SHARDS)));
+    }
+    ShardedBinTree tree(splitters);
+
+    vector<set<int> > owned(threadCount);      // serial reference per thread
+    vector<atomic<int> > sharedWins(SHARED);
+    for (int i = 0; i < SHARED; i++) {
+        sharedWins[i] = 0;
+    }
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(thread([&, t]() {
+            set<int> &mine = owned[t];
+            unsigned seed = t + 1;
+            int nextShared = t * SHARED / threadCount;
+            for (int op = 0; op < operations; op++) {
+                int key = (rand_r(&seed) % (OWNED / threadCount))
+                          * threadCount + t;
+                bool present = mine.count(key) > 0;
+                NodeData* found = NULL;
+                switch (rand_r(&seed) % 4) {
+                case 0:
+                case 1: {
+                    NodeData* newData = new NodeData(keyFor(key));
+                    if (tree.insert(newData) == present) {
+                        fail("insert disagrees with reference: " + keyFor(key));
+                    }
+                    if (present) {
+                        delete newData;        // caller keeps duplicates
+                    }
+                    mine.insert(key);
+                    break;
+                }
+                case 2:
+                    if (tree.remove(NodeData(keyFor(key))) != present) {
+                        fail("remove disagrees with reference: " + keyFor(key));
+                    }
+                    mine.erase(key);
+                    break;
+                default:
+                    if (tree.retrieve(NodeData(keyFor(key)), found) != present
+                        || (present && found->getData() != keyFor(key))) {
+                        fail("retrieve disagrees with reference: "
+                             + keyFor(key));
+                    }
+                    if (present && tree.getHeight(NodeData(keyFor(key))) < 1) {
+                        fail("present key has no height: " + keyFor(key));
+                    }
+                }
+
+                // every thread races for every shared key, each from its
+                // own starting point so they collide all through the run
+                if (op % 8 == 0) {
+                    int shared = nextShared++ % SHARED;
+                    NodeData* newData = new NodeData(keyFor(OWNED + shared));
+                    if (tree.insert(newData)) {
+                        sharedWins[shared]++;
+                    } else {
+                        delete newData;
+                    }
+                }
+                if (op % 1024 == 0 && tree.size() < 0) {
+                    fail("negative size");
+                }
+            }
+            for (int shared = 0; shared < SHARED; shared++) {
+                NodeData* newData = new NodeData(keyFor(OWNED + shared));
+                if (tree.insert(newData)) {
+                    sharedWins[shared]++;
+                } else {
+                    delete newData;
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    // merged serial reference, in key order
+    set<int> reference;
+    for (int t = 0; t < threadCount; t++) {
+        reference.insert(owned[t].begin(), owned[t].end());
+    }
+    for (int shared = 0; shared < SHARED; shared++) {
+        if (sharedWins[shared] != 1) {
+            fail("shared key inserted other than once: "
+                 + keyFor(OWNED + shared));
+        }
+        reference.insert(OWNED + shared);
+    }
+    if (tree.size() != (int)reference.size()) {
+        fail("size differs from the serial reference");
+    }
+
+    BinTree drained(true);
+    tree.drainInto(drained);
+    set<int>::const_iterator expected = reference.begin();
+    for (BinTree::const_iterator it = drained.begin(); it != drained.end();
+         ++it) {
+        if (expected == reference.end() || it->getData() != keyFor(*expected)) {
+            fail("drained tree differs from the serial reference at "
+                 + it->getData());
+        }
+        ++expected;
+    }
+    if (expected != reference.end() || tree.size() != 0
+        || !drained.isBalanced()) {
+        fail("drained tree is missing keys or unbalanced");
+    }
+    cout << "shardedstress: OK, " << reference.size() << " keys, "
+         << threadCount << " threads, " << tree.shardCount() << " shards"
+         << endl;
+    return 0;
+}
@@ -0,0 +1,28 @@
+//
+//  treeengine.h
+//
+//  SearchTree: the ordered set of NodeData that client code builds, chosen
+//  when compiling. By default it is BinTree; defining USE_BPLUSTREE (for
+//  example -DUSE_BPLUSTREE) selects BPlusTree, which keeps the same
+//  interface with cache-line sized nodes and linked leaves.
+//
+//  Assumptions:
+//     -- Client code names only SearchTree and the operations both engines
+//        share: insert, retrieve, getHeight, height, size, isEmpty,
+//        makeEmpty, displaySideways, operator<<, ==, !=, =, swap,
+//        bstreeToArray and arrayToBSTree
+//     -- getHeight and displaySideways describe the shape of whichever
+//        engine is built, so their output differs between the two
+
+#ifndef TREEENGINE_H
+#define TREEENGINE_H
+
+#ifdef USE_BPLUSTREE
+#include "bplustree.h"
+typedef BPlusTree SearchTree;
+#else
+#include "bintree.h"
+typedef BinTree SearchTree;
+#endif
+
+#endif
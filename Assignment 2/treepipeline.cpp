@@ -0,0 +1,191 @@
+//
+//  treepipeline.cpp
+//
+//  TreePipeline Object: runs lab2's test of every tree in a data file, with
+//  the trees worked on in parallel. One thread reads and splits the input
+//  into one job per "$$"-terminated tree, a pool of workers each builds a
+//  tree, runs the retrieve, height, copy and flatten-and-rebuild checks on
+//  it and renders their output, and the calling thread prints the results.
+//  Every job's result is a future queued in input order as the job is read,
+//  so the printer waits for each tree in turn and the output is exactly
+//  what lab2's loop prints, whatever order the workers finish in. Both
+//  queues are bounded, so at most a window of trees is in memory at once.
+//
+//  Assumptions:
+//     -- The trees in the file are independent; the only checks comparing
+//        two trees ("T != first?" and "T == dup?") are made by the printer
+//     -- Nothing else writes to the output stream during run
+
+#include "treepipeline.h"
+#include "boundedqueue.h"
+#include "treetokenizer.h"
+#include <sstream>
+#include <thread>
+using namespace std;
+
+// values lab2 retrieves, then the values whose heights it prints
+static const char* const RETRIEVED[3] = { "and", "not", "sss" };
+static const char* const MEASURED[6] = { "and", "not", "sss", "tttt", "ooo", "y" };
+
+
+/**
+ * TreePipeline ----------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : stores the number of workers and the read-ahead window, each at least one
+ */
+
+TreePipeline::TreePipeline(int workers, int window) {
+    this->workers = workers > 0 ? workers : 1;
+    this->window = window > 0 ? window : 1;
+}
+
+
+/**
+ * run --------------------------------------------------------------------------------------------------------------------------------------------
+ * run : starts a reader thread and the workers, then prints on the calling thread. The reader queues each job's future
+ * for the printer before handing the job to the workers, so the printer always knows which tree comes next; once
+ * window futures are waiting to be printed the reader stops until the printer catches up. When the input runs out
+ * the reader closes the work queue, the workers finish what is queued and exit, and the printer drains the futures.
+ *
+ * @param input : lab2 data, read from where the stream is now
+ * @param out : stream the results are printed to
+ * pre: no other thread writes to out until run returns
+ * post: every tree of input has been printed in order, and input is at its end
+ * @return: the number of trees read
+ */
+
+long TreePipeline::run(istream &input, ostream &out) {
+    BoundedQueue<unique_ptr<Job> > work(window);
+    BoundedQueue<future<unique_ptr<Result> > > ordered(window);
+
+    thread reader([&input, &work, &ordered] {
+        TreeTokenizer tokens(input);
+        for (;;) {
+            unique_ptr<Job> job(new Job());
+            const char* s;
+            size_t length;
+            TreeTokenizer::Token token;
+            bool read = false;                  // whether any token was found
+            while ((token = tokens.next(s, length)) != TreeTokenizer::INPUT_END) {
+                read = true;
+                if (token == TreeTokenizer::TREE_END) {
+                    job->echo += "$$ ";
+                    break;
+                }
+                job->keys.push_back(make_pair(job->echo.size(), length));
+                job->echo.append(s, length);
+                job->echo += ' ';
+            }
+            if (!read) {
+                break;                          // no more lines of data
+            }
+            ordered.push(job->done.get_future());
+            work.push(std::move(job));
+        }
+        work.close();
+        ordered.close();
+    });
+
+    vector<thread> pool;
+    for (int i = 0; i < workers; i++) {
+        pool.push_back(thread([&work] {
+            unique_ptr<Job> job;
+            while (work.pop(job)) {
+                job->done.set_value(analyze(*job));
+            }
+        }));
+    }
+
+    SearchTree first;                           // copy of the first tree
+    SearchTree previous;                        // the tree printed last
+    long count = 0;
+    future<unique_ptr<Result> > next;
+    while (ordered.pop(next)) {
+        unique_ptr<Result> result = next.get();
+        if (count == 0) {
+            first = result->tree;
+            previous = result->tree;
+        }
+        print(out, *result, first, previous);
+        previous.swap(result->tree);            // dup = T
+        count++;
+    }
+    if (count == 0) {
+        out << "Initial data:" << "\n" << "  " << "\n";
+    }
+    out.flush();
+
+    reader.join();
+    for (size_t i = 0; i < pool.size(); i++) {
+        pool[i].join();
+    }
+    return count;
+}
+
+
+/**
+ * analyze ----------------------------------------------------------------------------------------------------------------------------------------
+ * analyze : builds the tree from the job's keys, deleting duplicates as buildTree does, then makes lab2's checks on
+ * it in the same order: retrieve, getHeight, assignment and ==, and a flatten to an array and rebuild of a copy.
+ * Their output is rendered here, on the worker, into the text before and after the two checks only the printer
+ * can make.
+ *
+ * @param job : tree read from the input; its keys are not changed
+ * @return: the tree and the rendered output
+ */
+
+unique_ptr<TreePipeline::Result> TreePipeline::analyze(Job &job) {
+    unique_ptr<Result> result(new Result());
+    SearchTree &T = result->tree;
+    const char* text = job.echo.data();
+    for (size_t i = 0; i < job.keys.size(); i++) {
+        NodeData* ptr = new NodeData(text + job.keys[i].first, job.keys[i].second);
+        if (!T.insert(ptr)) {
+            delete ptr;                         // duplicate case, not inserted
+        }
+    }
+
+    ostringstream before;
+    before << "Initial data:" << "\n" << "  " << job.echo << "\n";
+    before << "Tree Inorder:" << "\n" << T;
+    T.displaySideways(before);
+    NodeData* p;
+    for (int i = 0; i < 3; i++) {
+        bool found = T.retrieve(NodeData(RETRIEVED[i]), p);
+        before << "Retrieve --> " << RETRIEVED[i] << ":  " << (found ? "found" : "not found") << "\n";
+    }
+    for (int i = 0; i < 6; i++) {
+        before << "Height    --> " << MEASURED[i] << ":  " << T.getHeight(NodeData(MEASURED[i])) << "\n";
+    }
+    SearchTree T2;
+    T2 = T;
+    before << "T == T2?     " << (T == T2 ? "equal" : "not equal") << "\n";
+    result->before = before.str();
+
+    ostringstream after;
+    vector<NodeData*> items;
+    T2.bstreeToArray(items);
+    T2.arrayToBSTree(items.data(), (int)items.size());
+    T2.displaySideways(after);
+    after << "---------------------------------------------------------------" << "\n";
+    result->after = after.str();
+    return result;
+}
+
+
+/**
+ * print ------------------------------------------------------------------------------------------------------------------------------------------
+ * print : prints the block lab2 prints for one tree, from its "Initial data:" line to the dashes after it
+ *
+ * @param out : stream to be written to
+ * @param result : the tree and its rendered output
+ * @param first : the first tree of the input
+ * @param previous : the tree before this one, or this one if it is the first
+ */
+
+void TreePipeline::print(ostream &out, const Result &result, const SearchTree &first,
+                         const SearchTree &previous) {
+    out << result.before;
+    out << "T != first?  " << (result.tree != first ? "not equal" : "equal") << "\n";
+    out << "T == dup?    " << (result.tree == previous ? "equal" : "not equal") << "\n";
+    out << result.after;
+}
@@ -0,0 +1,76 @@
+//
+//  treepipeline.h
+//
+//  TreePipeline Object: runs lab2's test of every tree in a data file, with
+//  the trees worked on in parallel. One thread reads and splits the input
+//  into one job per "$$"-terminated tree, a pool of workers each builds a
+//  tree, runs the retrieve, height, copy and flatten-and-rebuild checks on
+//  it and renders their output, and the calling thread prints the results.
+//  Every job's result is a future queued in input order as the job is read,
+//  so the printer waits for each tree in turn and the output is exactly
+//  what lab2's loop prints, whatever order the workers finish in. Both
+//  queues are bounded, so at most a window of trees is in memory at once.
+//
+//  Assumptions:
+//     -- The trees in the file are independent; the only checks comparing
+//        two trees ("T != first?" and "T == dup?") are made by the printer
+//     -- Nothing else writes to the output stream during run
+
+#ifndef TREEPIPELINE_H
+#define TREEPIPELINE_H
+#include <future>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "treeengine.h"
+using namespace std;
+
+class TreePipeline {
+
+public:
+    // TreePipeline -------------------------------------------------------
+    // Constructor : uses the given number of workers (at least one), and
+    // lets at most window trees be read ahead of the one being printed
+    explicit TreePipeline(int workers, int window = 64);
+
+    // run ------------------------------------------------------------------
+    // tests every tree of the input, printing to out as lab2 does; returns
+    // the number of trees
+    long run(istream &, ostream &);
+
+private:
+    // The checks on one tree, as lab2 makes them
+    struct Result {
+        SearchTree tree;                       // the tree as built
+        string before;                         // output up to "T != first?"
+        string after;                          // output from the rebuild on
+    };
+
+    // One tree read from the input
+    struct Job {
+        string echo;                           // tokens, each followed by ' '
+        vector<pair<size_t, size_t> > keys;    // start and length in echo
+        promise<unique_ptr<Result> > done;     // fulfilled by a worker
+    };
+
+    int workers;                               // worker threads
+    int window;                                // trees read ahead at most
+
+
+    // Utility functions //////////////////////////////////////////////
+
+    // analyze --------------------------------------------------------------
+    // builds the job's tree, runs the checks that need no other tree and
+    // renders their output
+    static unique_ptr<Result> analyze(Job &);
+
+    // print ----------------------------------------------------------------
+    // prints one tree's block of output, comparing it with the first tree
+    // and with the tree before it
+    static void print(ostream &, const Result &, const SearchTree &, const SearchTree &);
+};
+
+#endif
@@ -0,0 +1,200 @@
+//
+//  treetokenizer.cpp
+//
+//  TreeTokenizer Object: splits the lab2 data format, whitespace separated
+//  strings with each tree ended by "$$", into tokens without a string per
+//  token. The input is pulled from the stream's buffer a block at a time,
+//  and each token is handed out as a pointer and length into that block,
+//  so the only copy of a key is the one made by whoever keeps it. Words
+//  are scanned eight bytes at a time for the first whitespace character.
+//
+//  Assumptions:
+//     -- Whitespace is what operator>> skips in the "C" locale: space, tab,
+//        and the line, vertical tab, form feed and carriage return characters
+//     -- "$$" ends a tree only as a whole token, as with operator>>
+//     -- A token is valid until the next call to next or atEnd; a token
+//        longer than a block grows the block to fit it
+//     -- The tokenizer reads the stream's buffer directly, so the stream must
+//        not be read any other way while the tokenizer is in use
+
+#include "treetokenizer.h"
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+
+// Constructor ///////////////////////////////////////////////////////////////
+
+/**
+ * TreeTokenizer ----------------------------------------------------------------------------------------------------------------------------------
+ * Constructor : tokenizes the given stream from where it is now. Nothing is read until the first token is asked for.
+ *
+ * @param source : stream holding the data; must outlive the tokenizer
+ */
+
+TreeTokenizer::TreeTokenizer(istream &source) : input(source), buffer(BLOCK_SIZE) {
+    pos = 0;
+    filled = 0;
+    exhausted = false;
+}
+
+
+// Mutators //////////////////////////////////////////////////////////////////////
+
+/**
+ * next -------------------------------------------------------------------------------------------------------------------------------------------
+ * next : skips whitespace, then finds where the token ends. If it runs to the end of the buffer, the token may
+ * continue in the next block, so the block is refilled (keeping the token's start) and the scan resumes where it
+ * stopped. The last token of the input is returned even when no whitespace follows it.
+ *
+ * @param start : set to the token's first character for a WORD
+ * @param length : set to the token's length for a WORD
+ * pre: none
+ * post: the tokenizer is past the token; start and length stay valid until the next call
+ * @return: WORD for a key, TREE_END for "$$", INPUT_END if only whitespace was left
+ */
+
+TreeTokenizer::Token TreeTokenizer::next(const char* &start, size_t &length) {
+    if (!skipSpace()) {
+        return INPUT_END;
+    }
+    size_t end = scanWord(pos);
+    while (end == filled && !exhausted) {       // the token may go on
+        size_t scanned = end - pos;
+        fill();                                 // moves the token to the front
+        end = scanWord(pos + scanned);
+    }
+    const char* token = buffer.data() + pos;
+    size_t size = end - pos;
+    pos = end;
+    if (size == 2 && token[0] == '$' && token[1] == '$') {
+        return TREE_END;
+    }
+    start = token;
+    length = size;
+    return WORD;
+}
+
+
+/**
+ * atEnd ------------------------------------------------------------------------------------------------------------------------------------------
+ * atEnd : skips whitespace, reading more if needed
+ *
+ * pre: none
+ * post: the tokenizer is past any whitespace; a token handed out before is no longer valid
+ * @return: true if the input has no token left
+ */
+
+bool TreeTokenizer::atEnd() {
+    return !skipSpace();
+}
+
+
+// Utility functions /////////////////////////////////////////////////////////
+
+/**
+ * fill -------------------------------------------------------------------------------------------------------------------------------------------
+ * fill : keeps the unread bytes by moving them to the front, doubling the buffer if they already fill it, then
+ * reads as much of a block as the stream's buffer will give. The stream gets eofbit once it has nothing more.
+ *
+ * pre: none
+ * post: pos is 0 and filled counts the unread bytes
+ * @return: true if any bytes were read
+ */
+
+bool TreeTokenizer::fill() {
+    if (exhausted) {
+        return false;
+    }
+    if (pos > 0) {
+        memmove(buffer.data(), buffer.data() + pos, filled - pos);
+        filled -= pos;
+        pos = 0;
+    }
+    if (filled == buffer.size()) {
+        buffer.resize(buffer.size() * 2);       // one token fills the block
+    }
+    streamsize count = input.rdbuf()->sgetn(buffer.data() + filled, buffer.size() - filled);
+    if (count <= 0) {
+        exhausted = true;
+        input.setstate(ios::eofbit);
+        return false;
+    }
+    filled += (size_t)count;
+    return true;
+}
+
+
+/**
+ * skipSpace --------------------------------------------------------------------------------------------------------------------------------------
+ * skipSpace : advances past whitespace, reading blocks as needed
+ *
+ * pre: none
+ * post: pos is at a non-whitespace byte, or the input is exhausted
+ * @return: false if the input ended first
+ */
+
+bool TreeTokenizer::skipSpace() {
+    for (;;) {
+        while (pos < filled && isSpace(buffer[pos])) {
+            pos++;
+        }
+        if (pos < filled) {
+            return true;
+        }
+        if (!fill()) {
+            return false;
+        }
+    }
+}
+
+
+/**
+ * scanWord ---------------------------------------------------------------------------------------------------------------------------------------
+ * scanWord : looks at eight bytes at a time. Subtracting 0x21 from every byte at once borrows out of, and so sets
+ * the high bit of, each byte below 0x21 (bytes with their own high bit set are masked out), and the lowest such byte
+ * is found exactly; the borrow only runs toward higher bytes, so on a big-endian machine, where those come first, only
+ * the byte loop is used. Every whitespace character is below 0x21; the few other control characters that are too are
+ * checked and stepped over. The tail of fewer than eight bytes is scanned one byte at a time.
+ *
+ * @param from : index to start at; every byte before it is part of the token
+ * pre: from <= filled
+ * @return: index of the first whitespace byte at or after from, or filled if there is none
+ */
+
+size_t TreeTokenizer::scanWord(size_t from) const {
+    const uint64_t ONES = 0x0101010101010101ULL;
+    const uint64_t HIGHS = 0x8080808080808080ULL;
+    const char* bytes = buffer.data();
+    size_t i = from;
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (i + sizeof(uint64_t) <= filled) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        uint64_t below = (word - ONES * 0x21) & ~word & HIGHS;
+        if (below == 0) {
+            i += sizeof(word);
+            continue;
+        }
+        i += __builtin_ctzll(below) / 8;       // lowest address first
+        if (isSpace(bytes[i])) {
+            return i;
+        }
+        i++;                                    // another control character
+    }
+#endif
+    while (i < filled && !isSpace(bytes[i])) {
+        i++;
+    }
+    return i;
+}
+
+
+/**
+ * isSpace ----------------------------------------------------------------------------------------------------------------------------------------
+ * isSpace : true for the whitespace operator>> skips in the "C" locale
+ */
+
+bool TreeTokenizer::isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
@@ -0,0 +1,90 @@
+//
+//  treetokenizer.h
+//
+//  TreeTokenizer Object: splits the lab2 data format, whitespace separated
+//  strings with each tree ended by "$$", into tokens without a string per
+//  token. The input is pulled from the stream's buffer a block at a time,
+//  and each token is handed out as a pointer and length into that block,
+//  so the only copy of a key is the one made by whoever keeps it. Words
+//  are scanned eight bytes at a time for the first whitespace character.
+//
+//  Assumptions:
+//     -- Whitespace is what operator>> skips in the "C" locale: space, tab,
+//        and the line, vertical tab, form feed and carriage return characters
+//     -- "$$" ends a tree only as a whole token, as with operator>>
+//     -- A token is valid until the next call to next or atEnd; a token
+//        longer than a block grows the block to fit it
+//     -- The tokenizer reads the stream's buffer directly, so the stream must
+//        not be read any other way while the tokenizer is in use
+
+#ifndef TREETOKENIZER_H
+#define TREETOKENIZER_H
+#include <cstddef>
+#include <istream>
+#include <vector>
+using namespace std;
+
+class TreeTokenizer {
+
+public:
+    // what next found
+    enum Token {
+        WORD,                                  // a key, in the slice
+        TREE_END,                              // "$$"
+        INPUT_END                              // nothing is left
+    };
+
+    // bytes read from the stream at a time
+    static const size_t BLOCK_SIZE = 1 << 16;
+
+
+    // Constructor /////////////////////////////////////////////////////////
+
+    // TreeTokenizer ------------------------------------------------------
+    // Constructor : tokenizes the given stream from where it is now
+    explicit TreeTokenizer(istream &);
+
+
+    // Mutators ////////////////////////////////////////////////////////////
+
+    // next -----------------------------------------------------------------
+    // finds the next token; for a WORD, the slice is set to its characters,
+    // which stay valid until the next call
+    Token next(const char* &, size_t &);
+
+    // atEnd ----------------------------------------------------------------
+    // skips whitespace and returns true if no token is left, so a caller
+    // can tell the input is over before starting on another tree
+    bool atEnd();
+
+private:
+    istream &input;                            // source of the blocks
+    vector<char> buffer;                       // current block
+    size_t pos;                                // next unread byte
+    size_t filled;                             // bytes of buffer in use
+    bool exhausted;                            // true once a read gets none
+
+
+    // Utility functions //////////////////////////////////////////////
+
+    // fill -----------------------------------------------------------------
+    // moves the unread bytes to the front of the buffer and reads another
+    // block after them; returns false if the stream had nothing more
+    bool fill();
+
+    // skipSpace ------------------------------------------------------------
+    // advances past whitespace, reading blocks as needed; returns false if
+    // the input ends first
+    bool skipSpace();
+
+    // scanWord -------------------------------------------------------------
+    // index of the first whitespace byte at or after the given index, or
+    // filled if there is none in the buffer
+    size_t scanWord(size_t) const;
+
+    // isSpace --------------------------------------------------------------
+    // true if the character separates tokens
+    static bool isSpace(char);
+};
+
+#endif